@@ -0,0 +1,344 @@
+#pragma once
+#include <iostream>
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <functional>
+#include <type_traits>
+#include <limits>
+#include <thread>
+#include <cmath>
+#include "merge_sort.h"
+#include "in_place_quick_sort.h"
+#include "string_sort.h"
+#include "kway_merge.h"
+
+namespace adaptive_sort {
+
+// Алгоритмы, между которыми выбирает Sort
+enum class Algorithm {
+    NONE,             // Диапазон уже отсортирован
+    REVERSE,          // Диапазон строго убывает - достаточно развернуть его
+    INSERTION_SORT,   // Сортировка вставками (небольшие диапазоны)
+    RUN_MERGE,        // K-путевое слияние уже отсортированных отрезков (почти отсортированные данные)
+    RADIX_SORT,       // Поразрядная сортировка (целочисленные ключи)
+    STRING_SORT,      // Многоключевая быстрая сортировка строк (StringSort)
+    STD_SORT,         // Последовательная сортировка std::sort
+    STD_STABLE_SORT,  // Последовательная стабильная сортировка std::stable_sort
+    QUICK_SORT,       // Параллельная быстрая сортировка (InPlaceQuickSort)
+    MERGE_SORT        // Параллельная стабильная сортировка слиянием (MergeSort)
+};
+
+// Имена алгоритмов для вывода
+constexpr std::array<const char*, 10> ALGORITHM_NAMES = { "none", "reverse", "insertion_sort", "run_merge", "radix_sort", "string_sort",
+                                                          "std_sort", "std_stable_sort", "quick_sort", "merge_sort" };
+
+// Пороги выбора алгоритма (значения по умолчанию подобраны грубо, их стоит уточнять по журналу решений)
+struct SortThresholds {
+    size_t insertion_sort_size   = 32u;      // Размер, до которого используется сортировка вставками
+    size_t max_merged_runs       = 64u;      // Максимальное количество отсортированных отрезков для RUN_MERGE
+    size_t radix_sort_min_size   = 1u << 12; // Размер, начиная с которого целочисленные ключи сортируются поразрядно
+    size_t parallel_min_size     = 1u << 16; // Размер, начиная с которого используются параллельные алгоритмы
+    size_t duplicate_sample_size = 1024u;    // Размер выборки для оценки доли повторяющихся значений
+    double merge_sort_duplicates = 0.5;      // Доля повторов, начиная с которой MergeSort предпочтительнее InPlaceQuickSort
+};
+
+// Решение, принятое Sort, вместе с измерениями, на которых оно основано
+struct SortDecision {
+    Algorithm algorithm       = Algorithm::NONE;
+    bool      parallel        = false; // Используется ли параллельный алгоритм
+    bool      stable          = false; // Запрошена ли стабильная сортировка
+    size_t    size            = 0u;    // Размер диапазона
+    size_t    runs            = 0u;    // Количество неубывающих отрезков (если их больше max_merged_runs - первое превышающее значение)
+    double    duplicate_ratio = 0.0;   // Доля повторяющихся значений в выборке
+    unsigned  threads         = 1u;    // Количество доступных ядер
+};
+
+// Признаки типов ключей, для которых есть специальные алгоритмы
+template <typename Type>
+constexpr bool IS_RADIX_KEY = std::is_integral_v<Type> && !std::is_same_v<Type, bool>;
+
+template <typename Type>
+constexpr bool IS_STRING_KEY = std::is_convertible_v<const Type&, std::string_view> && !std::is_pointer_v<Type>;
+
+// Функция обратного вызова для журналирования решений
+using SortLogger = std::function<void(const SortDecision&)>;
+
+// Функция получения журнала решений (по умолчанию пустого), общего для всего процесса
+inline SortLogger& Logger() {
+    static SortLogger logger;
+    return logger;
+}
+
+// Функция установки журнала решений (следует вызывать при запуске, до первых сортировок в других потоках)
+inline void SetLogger(SortLogger logger) { Logger() = std::move(logger); }
+
+// Функция поразрядной (LSD, по байтам) сортировки целых чисел в диапазоне [begin; end) за O(N * sizeof(Type))
+// с буфером O(N). Знаковые числа сортируются инверсией старшего бита, а байты, одинаковые у всех чисел,
+// пропускаются. Сортировка стабильная
+template <typename RandomIt>
+void RadixSort(RandomIt begin, RandomIt end) {
+    using namespace std;
+
+    using Type     = typename iterator_traits<RandomIt>::value_type;
+    using Unsigned = make_unsigned_t<Type>;
+    static_assert(IS_RADIX_KEY<Type>, "radix sort requires integral keys");
+
+    constexpr size_t   BITS = numeric_limits<Unsigned>::digits;
+    constexpr Unsigned SIGN = is_signed_v<Type> ? static_cast<Unsigned>(Unsigned{ 1 } << (BITS - 1u)) : Unsigned{ 0 };
+
+    const size_t range_length = static_cast<size_t>(distance(begin, end));
+    if (range_length < 2u) return;
+
+    vector<Type> source(begin, end), target(range_length);
+
+    for (size_t shift = 0; shift < BITS; shift += 8u) {
+        auto digit = [shift](Type value) { return static_cast<size_t>((static_cast<Unsigned>(value) ^ SIGN) >> shift) & 0xFFu; };
+
+        // Считаем количество чисел с каждым значением байта
+        array<size_t, 256> counts = {};
+        for (const Type value : source) ++counts[digit(value)];
+
+        // Если байт у всех чисел одинаковый, проход ничего не меняет
+        if (counts[digit(source[0])] == range_length) continue;
+
+        // Превращаем количества в позиции и раскладываем числа
+        size_t position = 0u;
+        for (size_t& count : counts) position += exchange(count, position);
+        for (const Type value : source) target[counts[digit(value)]++] = value;
+
+        source.swap(target);
+    }
+
+    copy(source.begin(), source.end(), begin);
+}
+
+// Функция сортировки вставками для небольших диапазонов (стабильная)
+template <typename RandomIt>
+void InsertionSort(RandomIt begin, RandomIt end) {
+    using namespace std;
+
+    if (begin == end) return;
+
+    for (RandomIt current = next(begin); current != end; ++current) {
+        auto value = move(*current);
+
+        RandomIt it = current;
+        for (; it != begin && value < *prev(it); --it) *it = move(*prev(it));
+        *it = move(value);
+    }
+}
+
+// Функция подсчёта неубывающих отрезков диапазона [begin; end) за один проход (с ранним выходом, когда отрезков
+// становится больше max_runs и при этом диапазон уже заведомо не строго убывает), заполняет границы отрезков bounds
+// (если отрезков не больше max_runs), возвращает количество отрезков и признак строгого убывания
+template <typename RandomIt>
+std::pair<size_t, bool> CountRuns(RandomIt begin, RandomIt end, size_t max_runs, std::vector<size_t>& bounds) {
+    const size_t range_length = static_cast<size_t>(std::distance(begin, end));
+
+    size_t runs = 1u;
+    bool strictly_decreasing = true;
+
+    bounds.assign(1u, 0u);
+    for (size_t i = 1; i < range_length; ++i) {
+        if (begin[i] < begin[i - 1u]) {
+            if (++runs <= max_runs) bounds.push_back(i);
+        }
+        else strictly_decreasing = false;
+
+        if (runs > max_runs && !strictly_decreasing) break;
+    }
+    bounds.push_back(range_length);
+
+    return { runs, strictly_decreasing };
+}
+
+// Функция оценки доли повторяющихся значений по выборке из sample_size равномерно расположенных элементов
+template <typename RandomIt>
+double DuplicateRatio(RandomIt begin, RandomIt end, size_t sample_size) {
+    using namespace std;
+
+    const size_t range_length = static_cast<size_t>(distance(begin, end));
+    sample_size = min(sample_size, range_length);
+    if (sample_size < 2u) return 0.0;
+
+    vector<typename iterator_traits<RandomIt>::value_type> sample;
+    sample.reserve(sample_size);
+    for (size_t i = 0; i < sample_size; ++i) sample.push_back(begin[i * range_length / sample_size]);
+
+    // Значения сравниваются только через operator < (равны те, что не меньше друг друга), operator == не требуется
+    using Type = typename iterator_traits<RandomIt>::value_type;
+    auto equivalent = [](const Type& lhs, const Type& rhs) { return !(lhs < rhs) && !(rhs < lhs); };
+
+    sort(sample.begin(), sample.end());
+    const size_t distinct = static_cast<size_t>(unique(sample.begin(), sample.end(), equivalent) - sample.begin());
+
+    return 1.0 - static_cast<double>(distinct) / static_cast<double>(sample_size);
+}
+
+// Функция выбора алгоритма для диапазона [begin; end) по дешёвым измерениям: размеру, количеству уже
+// отсортированных отрезков (один проход с ранним выходом), доле повторов (по выборке) и типу ключа (на этапе
+// компиляции). Заполняет границы отрезков bounds для RUN_MERGE
+template <typename RandomIt>
+SortDecision Decide(RandomIt begin, RandomIt end, bool stable, const SortThresholds& thresholds, std::vector<size_t>& bounds) {
+    using namespace std;
+
+    using Type = typename iterator_traits<RandomIt>::value_type;
+
+    // Равные строки std::string неотличимы, поэтому стабильность для них не важна, а для string_view - важна
+    constexpr bool STRING_VALUE = is_same_v<Type, string>;
+
+    SortDecision decision;
+    decision.stable  = stable;
+    decision.size    = static_cast<size_t>(distance(begin, end));
+    decision.threads = max(1u, thread::hardware_concurrency());
+
+    // Пустой и одноэлементный диапазоны (в них не больше одного отрезка)
+    if (decision.size < 2u) { decision.runs = decision.size; decision.algorithm = Algorithm::NONE; return decision; }
+
+    // Уже отсортированные, строго убывающие, небольшие и почти отсортированные диапазоны
+    const auto [runs, strictly_decreasing] = CountRuns(begin, end, thresholds.max_merged_runs, bounds);
+    decision.runs = runs;
+
+    if (runs == 1u)                                      { decision.algorithm = Algorithm::NONE;           return decision; }
+    if (strictly_decreasing)                             { decision.algorithm = Algorithm::REVERSE;        return decision; }
+    if (decision.size <= thresholds.insertion_sort_size) { decision.algorithm = Algorithm::INSERTION_SORT; return decision; }
+
+    decision.duplicate_ratio = DuplicateRatio(begin, end, thresholds.duplicate_sample_size);
+
+    // Параллельные алгоритмы имеют смысл только на больших диапазонах и при нескольких ядрах
+    const bool parallel = decision.threads > 1u && decision.size >= thresholds.parallel_min_size;
+
+    if (runs <= thresholds.max_merged_runs) {
+        decision.algorithm = Algorithm::RUN_MERGE;
+        decision.parallel  = parallel;
+    }
+    else if (IS_RADIX_KEY<Type> && decision.size >= thresholds.radix_sort_min_size) {
+        decision.algorithm = Algorithm::RADIX_SORT;
+    }
+    else if (IS_STRING_KEY<Type> && parallel && (!stable || STRING_VALUE)) {
+        decision.algorithm = Algorithm::STRING_SORT;
+        decision.parallel  = true;
+    }
+    else if (!parallel) {
+        decision.algorithm = stable ? Algorithm::STD_STABLE_SORT : Algorithm::STD_SORT;
+    }
+    // При большой доле повторов разбиение быстрой сортировки впустую обменивает равные элементы,
+    // а сложность сортировки слиянием от распределения ключей не зависит
+    else if (stable || decision.duplicate_ratio >= thresholds.merge_sort_duplicates) {
+        decision.algorithm = Algorithm::MERGE_SORT;
+        decision.parallel  = true;
+    }
+    else {
+        decision.algorithm = Algorithm::QUICK_SORT;
+        decision.parallel  = true;
+    }
+
+    return decision;
+}
+
+// Функция сортировки диапазона [begin; end) по возрастанию (operator <) алгоритмом, выбранным по измерениям
+// (см. Decide), возвращает принятое решение и передаёт его в журнал, если он установлен. При stable = true
+// выбираются только стабильные алгоритмы
+template <typename RandomIt>
+SortDecision Sort(RandomIt begin, RandomIt end, bool stable = false, const SortThresholds& thresholds = SortThresholds()) {
+    using namespace std;
+
+    using Type = typename iterator_traits<RandomIt>::value_type;
+
+    vector<size_t> bounds;
+    const SortDecision decision = Decide(begin, end, stable, thresholds, bounds);
+
+    switch (decision.algorithm) {
+    case Algorithm::NONE:
+        break;
+
+    case Algorithm::REVERSE:
+        reverse(begin, end);
+        break;
+
+    case Algorithm::INSERTION_SORT:
+        InsertionSort(begin, end);
+        break;
+
+    case Algorithm::RUN_MERGE: {
+        // Сливаем отрезки в буфер (перемещением) и перемещаем результат обратно
+        vector<pair<move_iterator<RandomIt>, move_iterator<RandomIt>>> runs;
+        for (size_t run = 0; run + 1u < bounds.size(); ++run) {
+            runs.emplace_back(make_move_iterator(begin + bounds[run]), make_move_iterator(begin + bounds[run + 1u]));
+        }
+
+        vector<Type> merged(decision.size);
+        if (decision.parallel) kway_merge::ParallelKWayMerge(runs, merged.begin(), less<Type>(), decision.threads);
+        else                   kway_merge::KWayMerge(runs, merged.begin(), less<Type>());
+
+        move(merged.begin(), merged.end(), begin);
+        break;
+    }
+
+    case Algorithm::RADIX_SORT:
+        if constexpr (IS_RADIX_KEY<Type>) RadixSort(begin, end);
+        break;
+
+    case Algorithm::STRING_SORT:
+        if constexpr (IS_STRING_KEY<Type>) string_sort::StringSort(begin, end);
+        break;
+
+    case Algorithm::STD_SORT:
+        sort(begin, end);
+        break;
+
+    case Algorithm::STD_STABLE_SORT:
+        stable_sort(begin, end);
+        break;
+
+    case Algorithm::QUICK_SORT:
+        in_place_quick_sort::InPlaceQuickSort(begin, end);
+        break;
+
+    case Algorithm::MERGE_SORT:
+        merge_sort::MergeSort(begin, end);
+        break;
+    }
+
+    if (const SortLogger& logger = Logger()) logger(decision);
+
+    return decision;
+}
+
+// Функция стабильной сортировки диапазона [begin; end) алгоритмом, выбранным по измерениям
+template <typename RandomIt>
+SortDecision StableSort(RandomIt begin, RandomIt end, const SortThresholds& thresholds = SortThresholds()) {
+    return Sort(begin, end, true, thresholds);
+}
+
+// Перегрузки Sort и StableSort для контейнеров
+template <typename Range>
+auto Sort(Range& range, bool stable = false, const SortThresholds& thresholds = SortThresholds()) -> decltype(std::begin(range), SortDecision()) {
+    return Sort(std::begin(range), std::end(range), stable, thresholds);
+}
+
+template <typename Range>
+auto StableSort(Range& range, const SortThresholds& thresholds = SortThresholds()) -> decltype(std::begin(range), SortDecision()) {
+    return Sort(std::begin(range), std::end(range), true, thresholds);
+}
+
+// Перегрузка оператора "<<" для вывода решения в поток (одной строкой, удобной для разбора журнала)
+inline std::ostream& operator << (std::ostream& os, const SortDecision& decision) {
+    using namespace std;
+
+    os << "algorithm="s << ALGORITHM_NAMES[static_cast<size_t>(decision.algorithm)]
+       << " parallel="s << decision.parallel
+       << " stable="s << decision.stable
+       << " size="s << decision.size
+       << " runs="s << decision.runs
+       << " duplicate_ratio="s << decision.duplicate_ratio
+       << " threads="s << decision.threads;
+
+    return os;
+}
+
+}
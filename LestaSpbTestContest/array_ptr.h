@@ -1,4 +1,5 @@
 #pragma once
+#include <utility>
 
 namespace array_ptr {
 
@@ -0,0 +1,172 @@
+#pragma once
+#include <algorithm>
+#include <iterator>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <exception>
+
+// Асинхронная сортировка для корутин C++20, при сборке со стандартом ниже заголовок пуст
+#if defined(__cpp_impl_coroutine) && defined(__cpp_lib_jthread) && __has_include(<coroutine>)
+#include <coroutine>
+#include <stop_token>
+
+namespace async_sort {
+
+// Общее состояние асинхронной сортировки, которым владеют все её задачи
+//
+// Диапазон делится на leaves_ кусков (степень двойки), которые образуют полное двоичное дерево в "кучевой"
+// нумерации: у узла node дети 2 * node + 1 и 2 * node + 2, листья - узлы [leaves_ - 1; 2 * leaves_ - 1).
+// Каждый лист сортируется отдельной задачей на исполнителе, а внутренний узел сливает отсортированные половинки,
+// как только обе они готовы (это делает поток, закончивший вторую половинку). После слияния корня возобновляется
+// ожидающая корутина
+//
+// Исключение, выброшенное компаратором (или перемещением элементов), перехватывается в задаче и сохраняется,
+// оставшаяся работа пропускается как при отмене, но задачи по-прежнему сообщают о готовности, так что корутина
+// всегда возобновляется и получает исключение из co_await
+template <typename RandomIt, typename Executor, typename Comparator>
+struct SortState {
+    RandomIt   begin;
+    Comparator comparator;
+    Executor   executor;
+
+    std::stop_token         stop_token;   // Токен отмены
+    std::coroutine_handle<> continuation; // Ожидающая корутина
+
+    size_t leaves = 1u;                          // Количество листьев
+    std::vector<size_t> bounds;                  // Границы узлов: узел node занимает [bounds[2 * node]; bounds[2 * node + 1])
+    std::vector<std::atomic<int>> pending;       // Количество неготовых детей у каждого внутреннего узла
+    std::atomic<bool> cancelled = false;         // Была ли сортировка отменена (или прервана исключением)
+    std::atomic<bool> failed    = false;         // Было ли выброшено исключение
+    std::exception_ptr exception;                // Первое выброшенное исключение (видно корутине через счётчики pending)
+
+    SortState(RandomIt begin, size_t size, size_t leaves, Comparator comparator, Executor executor, std::stop_token stop_token)
+        : begin(begin), comparator(comparator), executor(std::move(executor)), stop_token(std::move(stop_token)),
+          leaves(leaves), bounds(4u * leaves), pending(leaves) {
+
+        // Разбиваем диапазон на узлы сверху вниз
+        bounds[0] = 0u; bounds[1] = size;
+        for (size_t node = 0; node + 1u < leaves; ++node) {
+            const size_t node_begin = bounds[2 * node], node_end = bounds[2 * node + 1], mid = node_begin + (node_end - node_begin) / 2u;
+
+            bounds[2 * (2 * node + 1)] = node_begin; bounds[2 * (2 * node + 1) + 1] = mid;
+            bounds[2 * (2 * node + 2)] = mid;        bounds[2 * (2 * node + 2) + 1] = node_end;
+
+            pending[node].store(2, std::memory_order_relaxed);
+        }
+    }
+
+    // Функция проверки отмены (после запроса отмены задачи пропускают работу, но продолжают сообщать о готовности)
+    bool stop_requested() {
+        if (stop_token.stop_requested()) cancelled.store(true, std::memory_order_relaxed);
+        return cancelled.load(std::memory_order_relaxed);
+    }
+
+    // Функция выполнения работы work, если сортировка не отменена: исключение сохраняется (только первое)
+    // и прерывает оставшуюся работу остальных задач
+    template <typename Work>
+    void run(Work work) noexcept {
+        if (stop_requested()) return;
+
+        try {
+            work();
+        }
+        catch (...) {
+            if (!failed.exchange(true, std::memory_order_relaxed)) exception = std::current_exception();
+            cancelled.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    // Функция сортировки листа и подъёма по дереву, покуда текущий поток заканчивает вторую половинку узла
+    static void run_leaf(std::shared_ptr<SortState> state, size_t node) {
+        using namespace std;
+
+        state->run([&state, node] {
+            stable_sort(state->begin + state->bounds[2 * node], state->begin + state->bounds[2 * node + 1], state->comparator);
+        });
+
+        while (node != 0u) {
+            const size_t parent = (node - 1u) / 2u;
+
+            // Если вторая половинка ещё не готова, её закончит другой поток
+            if (state->pending[parent].fetch_sub(1, memory_order_acq_rel) != 1) return;
+
+            node = parent;
+            state->run([&state, node] {
+                const size_t left = 2 * node + 1;
+                inplace_merge(state->begin + state->bounds[2 * node], state->begin + state->bounds[2 * left + 1],
+                              state->begin + state->bounds[2 * node + 1], state->comparator);
+            });
+        }
+
+        // Корень готов - возобновляем ожидающую корутину
+        state->continuation.resume();
+    }
+};
+
+// Класс ожидаемого объекта (awaitable) сортировки: co_await возвращает true, если сортировка закончена,
+// или false, если она была отменена через stop_token (тогда порядок элементов в диапазоне не определён).
+// Если компаратор выбросил исключение, co_await выбрасывает его (порядок элементов тоже не определён)
+template <typename RandomIt, typename Executor, typename Comparator>
+class SortAwaitable {
+private:
+    using State = SortState<RandomIt, Executor, Comparator>;
+
+    std::shared_ptr<State> state_;
+
+public:
+    SortAwaitable(RandomIt begin, RandomIt end, Executor executor, std::stop_token stop_token, Comparator comparator, size_t leaves) {
+        const size_t size = static_cast<size_t>(std::distance(begin, end));
+        state_ = std::make_shared<State>(begin, size, leaves, comparator, std::move(executor), std::move(stop_token));
+    }
+
+    // Пустой или одноэлементный диапазон уже отсортирован, корутина не приостанавливается
+    bool await_ready() const noexcept { return state_->bounds[1] < 2u; }
+
+    // Функция приостановки корутины: запускает сортировку листьев на исполнителе
+    void await_suspend(std::coroutine_handle<> continuation) {
+        // Копия указателя: последняя задача может возобновить корутину (и уничтожить этот объект) раньше выхода из функции
+        std::shared_ptr<State> state = state_;
+        state->continuation = continuation;
+
+        const size_t leaves = state->leaves;
+        for (size_t node = leaves - 1u; node < 2u * leaves - 1u; ++node) {
+            state->executor([state, node] { State::run_leaf(state, node); });
+        }
+    }
+
+    bool await_resume() const {
+        if (state_->exception) std::rethrow_exception(state_->exception);
+        return !state_->cancelled.load(std::memory_order_relaxed);
+    }
+};
+
+// Функция асинхронной сортировки диапазона [begin; end) для использования в корутинах: co_await AsyncSort(...)
+// разбивает работу на задачи, которые исполняются на переданном исполнителе executor (любой вызываемый объект,
+// принимающий std::function<void()>, например, очередь задач цикла событий или пул потоков), и возобновляет
+// корутину, когда сортировка закончена. Сортировка стабильная, вызывающий поток не блокируется
+template <typename RandomIt, typename Executor, typename Comparator>
+SortAwaitable<RandomIt, Executor, Comparator> AsyncSort(RandomIt begin, RandomIt end, Executor executor, std::stop_token stop_token, Comparator comparator) {
+    using namespace std;
+
+    // Количество листьев - степень двойки не меньше количества ядер, но листья не меньше MIN_LEAF_SIZE элементов
+    constexpr size_t MIN_LEAF_SIZE = 4096u;
+    const size_t size = static_cast<size_t>(distance(begin, end));
+
+    size_t leaves = 1u;
+    while (leaves < max(1u, thread::hardware_concurrency()) && size / (leaves * 2u) >= MIN_LEAF_SIZE) leaves *= 2u;
+
+    return SortAwaitable<RandomIt, Executor, Comparator>(begin, end, move(executor), move(stop_token), comparator, leaves);
+}
+
+// Перегрузка AsyncSort со стандартным компаратором
+template <typename RandomIt, typename Executor>
+auto AsyncSort(RandomIt begin, RandomIt end, Executor executor, std::stop_token stop_token = {}) {
+    return AsyncSort(begin, end, std::move(executor), std::move(stop_token), std::less<typename std::iterator_traits<RandomIt>::value_type>());
+}
+
+}
+
+#endif
\ No newline at end of file
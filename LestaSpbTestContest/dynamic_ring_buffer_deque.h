@@ -5,6 +5,7 @@
 #include <stdexcept>
 #include <initializer_list>
 #include "array_ptr.h"
+#include "instrumentation.h"
 
 namespace dynamic_ring_buffer_deque {
 
@@ -55,7 +56,7 @@ private:
         }
 
         // Функция обмена с другим итератором
-        void swap(const BasicIterator& rhs) {
+        void swap(BasicIterator& rhs) {
             std::swap(deque_, rhs.deque_);
             std::swap(index_, rhs.index_);
         }
@@ -104,7 +105,7 @@ private:
         // Оператор доступа к членам (полям и методам) элемента, на который указывает итератор
         pointer operator -> () const {
             using namespace std;
-            return deque_->buff_[index_];
+            return &deque_->buff_[index_];
         }
     };
 
@@ -216,6 +217,8 @@ public:
 
             // После чего перемещаем туда данные из старого буфера
             std::move(begin(), end(), tmp_buff_.get());
+            INSTRUMENTATION_ADD(DEQUE_REALLOCATIONS, 1);
+            INSTRUMENTATION_ADD(DEQUE_BYTES_MOVED, size_ * sizeof(Type));
 
             // Меняем буферы местами (старые ресурсы будут высвобождены после вызова деструктора tmp_buff_)
             buff_.swap(tmp_buff_);
@@ -244,8 +247,9 @@ public:
         std::swap(capacity_, other.capacity_);
         std::swap(buff_size_, other.buff_size_);
 
-        begin_.swap(other.begin_);
-        end_.swap(other.end_);
+        // Итераторы на начало и конец должны по-прежнему указывать на свой дек, поэтому обмениваем только индексы
+        std::swap(begin_.index_, other.begin_.index_);
+        std::swap(end_.index_, other.end_.index_);
     }
 
     // Функция получения размера
@@ -274,6 +278,7 @@ public:
         // Добавляем элемент в конец
         *(end_++) = lvalue;
         ++size_;
+        INSTRUMENTATION_MAX(DEQUE_HIGH_WATER_MARK, size_);
     }
 
     // Функция перемещения в конец (перемещение rvalue в конец) 
@@ -285,6 +290,7 @@ public:
         // Перемещаем элемент в конец
         *(end_++) = std::move(rvalue);
         ++size_;
+        INSTRUMENTATION_MAX(DEQUE_HIGH_WATER_MARK, size_);
     }
 
     // Функция добавления в начало (копирование lvalue в начало)
@@ -296,6 +302,7 @@ public:
         // Добавляем элемент в начало
         *(--begin_) = lvalue;
         ++size_;
+        INSTRUMENTATION_MAX(DEQUE_HIGH_WATER_MARK, size_);
     }
 
     // Функция перемещения в начало (перемещение rvalue в начало)
@@ -307,6 +314,7 @@ public:
         // Добавляем элемент в начало
         *(--begin_) = std::move(rvalue);
         ++size_;
+        INSTRUMENTATION_MAX(DEQUE_HIGH_WATER_MARK, size_);
     }
 
     // Функция удаления из конца
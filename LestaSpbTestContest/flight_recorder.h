@@ -0,0 +1,132 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "static_ring_buffer_deque.h"
+
+namespace flight_recorder {
+
+// Класс "бортового самописца" на кольцевом буфере: хранит последние capacity_ элементов (например, времена
+// кадров или события), которые пишет один поток, а читать согласованный снимок окна могут любые потоки
+//
+// Запись никогда не блокируется и не выбрасывает исключений: при заполненном буфере перезаписывается самый
+// старый элемент. Чтение устроено по принципу seqlock, но вместо повтора чтения при конфликте с писателем
+// отбрасываются только те старые элементы, которые писатель успел перезаписать во время копирования:
+//
+//     begun_   - количество начатых  записей (увеличивается до записи элемента)
+//     written_ - количество законченных записей (увеличивается после записи элемента)
+//
+// Читатель запоминает written_, копирует окно, после чего смотрит begun_: элемент с порядковым номером i
+// мог быть испорчен, только если была начата запись с номером i + capacity_, т.е. i < begun_ - capacity_
+// (поэтому тип элементов должен быть тривиально копируемым: испорченная копия просто отбрасывается)
+//
+// Чтобы одновременные запись и чтение элемента не были гонкой данных, элемент хранится как несколько
+// машинных слов (наибольших, на которые делится его размер), которые пишутся и читаются relaxed-атомарно,
+// а порядок между словами и счётчиками задают барьеры seqlock
+template <typename Type, size_t capacity_>
+class FlightRecorder {
+private:
+    static_assert(std::is_trivially_copyable_v<Type>, "flight-recorder element type must be trivially copyable");
+    static_assert(std::is_default_constructible_v<Type>, "flight-recorder element type must be default constructible");
+
+    // Слово, которым копируется элемент
+    using Word = std::conditional_t<sizeof(Type) % 8u == 0u, uint64_t,
+                 std::conditional_t<sizeof(Type) % 4u == 0u, uint32_t,
+                 std::conditional_t<sizeof(Type) % 2u == 0u, uint16_t, uint8_t>>>;
+
+    static constexpr size_t WORDS = sizeof(Type) / sizeof(Word); // Количество слов в элементе
+
+    static_assert(std::atomic<Word>::is_always_lock_free, "flight-recorder requires lock-free atomic words");
+
+    std::array<std::atomic<Word>, capacity_ * WORDS> buff_ = {}; // Буфер данных (элемент с номером i - слова [i * WORDS; (i + 1) * WORDS))
+
+    alignas(64) std::atomic<uint64_t> begun_   = 0u; // Количество начатых записей
+    alignas(64) std::atomic<uint64_t> written_ = 0u; // Количество законченных записей
+
+public:
+    // Конструктор по умолчанию создаёт пустой самописец
+    explicit FlightRecorder() = default;
+
+    // Копирование и перемещение запрещены (с самописцем одновременно работают разные потоки)
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator = (const FlightRecorder&) = delete;
+
+private:
+    // Функция записи элемента в ячейку slot по словам
+    void store(size_t slot, const Type& value) noexcept {
+        Word words[WORDS];
+        std::memcpy(words, &value, sizeof(Type));
+        for (size_t word = 0; word < WORDS; ++word) buff_[slot * WORDS + word].store(words[word], std::memory_order_relaxed);
+    }
+
+    // Функция чтения элемента из ячейки slot по словам
+    Type load(size_t slot) const noexcept {
+        Word words[WORDS];
+        for (size_t word = 0; word < WORDS; ++word) words[word] = buff_[slot * WORDS + word].load(std::memory_order_relaxed);
+
+        Type value;
+        std::memcpy(&value, words, sizeof(Type));
+        return value;
+    }
+
+public:
+
+    // Функция добавления элемента в конец (вызывается только из одного потока-писателя)
+    void push_back(const Type& value) noexcept {
+        using namespace std;
+
+        const uint64_t index = written_.load(memory_order_relaxed);
+
+        // Сначала объявляем о начале записи, чтобы читатели не доверяли перезаписываемому элементу
+        begun_.store(index + 1u, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+
+        // Затем записываем элемент и публикуем его
+        store(static_cast<size_t>(index % capacity_), value);
+        written_.store(index + 1u, memory_order_release);
+    }
+
+    // Функция получения количества элементов в окне
+    size_t size() const noexcept {
+        const uint64_t written = written_.load(std::memory_order_acquire);
+        return static_cast<size_t>(written < capacity_ ? written : capacity_);
+    }
+
+    // Функция получения общего количества записанных элементов (в том числе уже вытесненных)
+    uint64_t total_written() const noexcept { return written_.load(std::memory_order_acquire); }
+
+    // Функция получения согласованного снимка окна в дек snapshot (может вызываться из любого потока)
+    // (никогда не ждёт писателя: если он успел перезаписать старые элементы во время копирования, они не попадут в снимок)
+    template <typename ErrorPolicy>
+    void snapshot(static_ring_buffer_deque::StaticRingBufferDeque<Type, capacity_, ErrorPolicy>& snapshot) const noexcept {
+        using namespace std;
+
+        snapshot.clear();
+
+        // Окно на момент начала чтения: элементы с порядковыми номерами [first; written)
+        const uint64_t written = written_.load(memory_order_acquire);
+        const uint64_t first   = written < capacity_ ? 0u : written - capacity_;
+
+        // Копируем окно
+        for (uint64_t index = first; index < written; ++index) snapshot.push_back_overwrite(load(static_cast<size_t>(index % capacity_)));
+
+        // Узнаём, какие записи были начаты за время копирования
+        atomic_thread_fence(memory_order_acquire);
+        const uint64_t begun = begun_.load(memory_order_relaxed);
+
+        // Отбрасываем из начала снимка элементы, которые могли быть перезаписаны
+        const uint64_t valid_first = begun < capacity_ ? 0u : begun - capacity_;
+        for (uint64_t index = first; index < valid_first && !snapshot.is_empty(); ++index) snapshot.pop_front();
+    }
+
+    // Функция получения согласованного снимка окна (аналогична предыдущей, но возвращает новый дек)
+    static_ring_buffer_deque::StaticRingBufferDeque<Type, capacity_> snapshot() const noexcept {
+        static_ring_buffer_deque::StaticRingBufferDeque<Type, capacity_> result;
+        snapshot(result);
+        return result;
+    }
+};
+
+}
\ No newline at end of file
@@ -1,7 +1,38 @@
 #pragma once
+#include <algorithm>
+#include <iterator>
+#include <future>
+#include <cmath>
+#include <vector>
+#include <thread>
+#include <functional>
+#include "instrumentation.h"
 
 namespace in_place_quick_sort {
 
+// Функция выбора опорного элемента как медианы из трёх (крайних и среднего): упорядочивает эти три
+// элемента между собой, так что медиана оказывается в середине полуинтервала [begin;end), где её
+// и возьмёт в качестве опорного элемента InPlaceQuickSortPartition
+// (защищает от квадратичного поведения на уже упорядоченных и почти упорядоченных данных)
+template <typename RandomAccessIterator, typename Comparator>
+void MedianOfThreeToMiddle(RandomAccessIterator begin, RandomAccessIterator end, Comparator comparator) {
+    using namespace std;
+
+    // Для полуинтервалов из менее, чем 3 элементов медиана не имеет смысла
+    if (distance(begin, end) < 3) return;
+
+    RandomAccessIterator first = begin;     // Итератор на левый  крайний элемент
+    RandomAccessIterator last  = prev(end); // Итератор на правый крайний элемент
+
+    // Итератор на средний элемент (тот же, что выбирает InPlaceQuickSortPartition)
+    RandomAccessIterator middle = begin; advance(middle, distance(begin, end) / 2);
+
+    // Сортировка трёх элементов тремя сравнениями
+    if (comparator(*middle, *first)) swap(*middle, *first);
+    if (comparator(*last,   *first)) swap(*last,   *first);
+    if (comparator(*last,  *middle)) swap(*last,  *middle);
+}
+
 // Функция поиска опорного элемента и упорядочивания относительно него
 template <typename RandomAccessIterator, typename Comparator>
 RandomAccessIterator InPlaceQuickSortPartition(RandomAccessIterator begin, RandomAccessIterator end, Comparator comparator) {
@@ -23,12 +54,127 @@ RandomAccessIterator InPlaceQuickSortPartition(RandomAccessIterator begin, Rando
 
         if (distance(left, right) > 0) { swap(*left, *right); ++left; --right; } // Если итератор левого края левее итератора правого края, меняем эти элементы местами
         else break;                                                              // А иначе выходим из цикла
+
+        // Обмен - это два перемещения элементов (при включённом инструментировании)
+        INSTRUMENTATION_ADD(ELEMENT_MOVES, 2);
     }
     
     // Теперь опорным элементом будет тот, на который указывает итератор левого края
     return left;
 }
 
+// Размер полуинтервала, начиная с которого разбиение выполняется параллельно
+constexpr std::ptrdiff_t PARALLEL_PARTITION_THRESHOLD = 1 << 16;
+
+// Функция параллельного разбиения полуинтервала [begin;end) на месте: элементы, для которых predicate истинен,
+// переносятся в начало, возвращается итератор на первый элемент, для которого он ложен (порядок не сохраняется)
+//
+// 1. Полуинтервал делится на threads блоков, каждый поток разбивает свой блок на месте (std::partition)
+// 2. Итоговая граница находится как сумма (prefix sum) количеств "левых" элементов по блокам
+// 3. "Нейтрализация": "правые" элементы левее границы и "левые" элементы правее границы лежат в отрезках на
+//    концах блоков, их количества равны, так что их достаточно попарно обменять; номера этих элементов делятся
+//    между потоками поровну, и каждый поток находит свои отрезки бинарным поиском по префиксным суммам
+template <typename RandomAccessIterator, typename Predicate>
+RandomAccessIterator ParallelPartition(RandomAccessIterator begin, RandomAccessIterator end, Predicate predicate, size_t threads) {
+    using namespace std;
+
+    const size_t range_length = static_cast<size_t>(distance(begin, end));
+    threads = max<size_t>(1u, min(threads, range_length));
+
+    const size_t block_size = (range_length + threads - 1u) / threads;
+    auto block_begin = [&](size_t block) { return min(block * block_size, range_length); };
+
+    // Запускает задачу task(i) для i в [0; threads) параллельно с помощью std::async (нулевую - в текущем потоке)
+    auto parallel_for = [threads](auto task) {
+        vector<future<void>> futures;
+        for (size_t i = 1u; i < threads; ++i) futures.push_back(async(task, i));
+        task(0u);
+        for (auto& f : futures) f.get();
+    };
+
+    // 1. Разбиваем блоки параллельно, запоминая границу внутри каждого блока
+    vector<size_t> splits(threads);
+    parallel_for([&](size_t block) {
+        splits[block] = static_cast<size_t>(partition(begin + block_begin(block), begin + block_begin(block + 1u), predicate) - begin);
+    });
+
+    // 2. Итоговая граница - сумма количеств "левых" элементов по блокам
+    size_t boundary = 0u;
+    for (size_t block = 0; block < threads; ++block) boundary += splits[block] - block_begin(block);
+
+    // 3. Собираем отрезки элементов не на своём месте: "правые" левее границы (wrong_left) и "левые" правее (wrong_right),
+    //    с префиксными суммами длин (отрезок k начинается в общей нумерации с *_offsets[k])
+    vector<pair<size_t, size_t>> wrong_left, wrong_right;
+    vector<size_t> left_offsets(1u, 0u), right_offsets(1u, 0u);
+
+    for (size_t block = 0; block < threads; ++block) {
+        const size_t first = block_begin(block), split = splits[block], last = block_begin(block + 1u);
+
+        // "Правые" элементы блока [split; last), попавшие левее границы
+        if (split < boundary && split < last) {
+            wrong_left.emplace_back(split, min(last, boundary));
+            left_offsets.push_back(left_offsets.back() + (min(last, boundary) - split));
+        }
+        // "Левые" элементы блока [first; split), попавшие правее границы
+        if (split > boundary && first < split) {
+            wrong_right.emplace_back(max(first, boundary), split);
+            right_offsets.push_back(right_offsets.back() + (split - max(first, boundary)));
+        }
+    }
+
+    // Количество элементов для обмена (одинаковое с обеих сторон)
+    const size_t misplaced = left_offsets.back();
+
+    // Обмениваем элементы с номерами [from; to) в общей нумерации (каждый поток - свою долю)
+    auto swap_task = [&](size_t part) {
+        size_t from = misplaced * part / threads;
+        const size_t to = misplaced * (part + 1u) / threads;
+        if (from == to) return;
+
+        // Находим отрезки, содержащие элемент с номером from, бинарным поиском по префиксным суммам
+        size_t l = static_cast<size_t>(upper_bound(left_offsets.begin(),  left_offsets.end(),  from) - left_offsets.begin())  - 1u;
+        size_t r = static_cast<size_t>(upper_bound(right_offsets.begin(), right_offsets.end(), from) - right_offsets.begin()) - 1u;
+
+        while (from < to) {
+            // Сколько элементов можно обменять, не выходя за пределы текущих отрезков
+            const size_t l_pos = wrong_left[l].first  + (from - left_offsets[l]);
+            const size_t r_pos = wrong_right[r].first + (from - right_offsets[r]);
+            const size_t count = min({ to - from, left_offsets[l + 1u] - from, right_offsets[r + 1u] - from });
+
+            swap_ranges(begin + l_pos, begin + (l_pos + count), begin + r_pos);
+            INSTRUMENTATION_ADD(ELEMENT_MOVES, 2 * count);
+
+            from += count;
+            if (from == left_offsets[l + 1u])  ++l;
+            if (from == right_offsets[r + 1u]) ++r;
+        }
+    };
+    if (misplaced) parallel_for(swap_task);
+
+    return begin + boundary;
+}
+
+// Функция параллельного поиска опорного элемента и упорядочивания относительно него (аналог InPlaceQuickSortPartition
+// для больших полуинтервалов): элементы в [begin;pivot) не больше опорного, в [pivot;end) - не меньше его.
+// Возвращает end, если все элементы равны (тогда полуинтервал уже упорядочен)
+template <typename RandomAccessIterator, typename Comparator>
+RandomAccessIterator InPlaceQuickSortParallelPartition(RandomAccessIterator begin, RandomAccessIterator end, Comparator comparator, size_t threads) {
+    using namespace std;
+
+    // Значение опорного элемента - медиана из трёх
+    MedianOfThreeToMiddle(begin, end, comparator);
+    const auto pivot_value = *(begin + distance(begin, end) / 2);
+
+    // Сначала отделяем элементы строго меньше опорного
+    RandomAccessIterator pivot = ParallelPartition(begin, end, [&](const auto& value) { return comparator(value, pivot_value); }, threads);
+
+    // Если таких нет (опорный элемент - минимальный), отделяем элементы, не большие опорного,
+    // их хотя бы один - сам опорный элемент, так что разбиение всегда продвигается
+    if (pivot == begin) pivot = ParallelPartition(begin, end, [&](const auto& value) { return !comparator(pivot_value, value); }, threads);
+
+    return pivot;
+}
+
 // Функция эффективной быстрой сортировки
 template <typename RandomAccessIterator, typename Comparator>
 void InPlaceQuickSort(RandomAccessIterator begin, RandomAccessIterator end, Comparator comparator, int max_async_depth, int depth) {
@@ -37,8 +183,22 @@ void InPlaceQuickSort(RandomAccessIterator begin, RandomAccessIterator end, Comp
     // Покуда в полуинтервале [begin;end) более, чем 1 элемент:
     if (distance(begin, end) > 1)
     {
-        // Находим опорный элемент
-        RandomAccessIterator pivot = InPlaceQuickSortPartition(begin, end, comparator);
+        // Замер времени на текущем уровне рекурсии (при включённом инструментировании)
+        INSTRUMENTATION_LEVEL_TIMER(depth);
+
+        // Потоки, приходящиеся на текущую задачу (на уровне depth параллельно работают до 2^depth задач)
+        const size_t threads = depth < 16 ? thread::hardware_concurrency() >> depth : 0u;
+
+        // Находим опорный элемент (при включённом инструментировании компаратор считает сравнения): на первых
+        // уровнях больших полуинтервалов - параллельным разбиением, чтобы были заняты все ядра, а иначе - обычным
+        RandomAccessIterator pivot;
+        if (threads > 1u && distance(begin, end) > PARALLEL_PARTITION_THRESHOLD) {
+            pivot = InPlaceQuickSortParallelPartition(begin, end, instrumentation::CountComparisons(comparator), threads);
+
+            // Если все элементы равны, полуинтервал уже упорядочен
+            if (pivot == end) return;
+        }
+        else pivot = InPlaceQuickSortPartition(begin, end, instrumentation::CountComparisons(comparator));
 
         // Задачи (лямбды) для сортировки полуинтервалов [begin;pivot) и [pivot;end)
         auto left_task  = [begin, pivot, comparator, max_async_depth, depth] { InPlaceQuickSort(begin, pivot, comparator, max_async_depth, depth + 1); };
@@ -47,6 +207,7 @@ void InPlaceQuickSort(RandomAccessIterator begin, RandomAccessIterator end, Comp
         // Если текущий уровень рекурсии меньше, чем максимальный - запускаем задачи по
         // сортировки половинок параллельно с помощью std::async
         if (depth <= max_async_depth) {
+            INSTRUMENTATION_ADD(ASYNC_TASKS, 1);
             auto left_future = async(left_task);
             right_task();
             left_future.get();
@@ -68,8 +229,45 @@ void InPlaceQuickSort(RandomAccessIterator begin, RandomAccessIterator end) {
     const int max_async_depth = static_cast<int>(log(static_cast<double>(end - begin)));
 
     // Запускаем эффективную быструю сортировку
-    InPlaceQuickSort(begin, end, [](const typename RandomAccessIterator::value_type& lhs,
-                                    const typename RandomAccessIterator::value_type& rhs) { return lhs < rhs; }, max_async_depth, 0);
+    InPlaceQuickSort(begin, end, [](const typename iterator_traits<RandomAccessIterator>::value_type& lhs,
+                                    const typename iterator_traits<RandomAccessIterator>::value_type& rhs) { return lhs < rhs; }, max_async_depth, 0);
 }
 
-}
\ No newline at end of file
+// Функция обмена элементов для вычислений на этапе компиляции (std::iter_swap constexpr только начиная с C++20)
+template <typename Iterator>
+constexpr void ConstexprIterSwap(Iterator lhs, Iterator rhs) {
+    auto value = std::move(*lhs);
+    *lhs = std::move(*rhs);
+    *rhs = std::move(value);
+}
+
+// Функция последовательной быстрой сортировки для вычислений на этапе компиляции (constexpr): то же разбиение
+// относительно медианы из трёх, что и в InPlaceQuickSort, но без потоков и инструментирования. Меньшая часть
+// сортируется рекурсивно, а большая - в цикле, так что глубина рекурсии O(log N) и не упирается в ограничения
+// компилятора на constexpr-вычисления
+template <typename RandomAccessIterator, typename Comparator = std::less<>>
+constexpr void ConstexprQuickSort(RandomAccessIterator begin, RandomAccessIterator end, Comparator comparator = Comparator()) {
+    while (end - begin > 1) {
+        // Медиана из трёх в середину полуинтервала
+        const RandomAccessIterator middle = begin + (end - begin) / 2, last = end - 1;
+        if (comparator(*middle, *begin)) ConstexprIterSwap(middle, begin);
+        if (comparator(*last,   *begin)) ConstexprIterSwap(last,   begin);
+        if (comparator(*last,  *middle)) ConstexprIterSwap(last,  middle);
+
+        // Разбиение (как в InPlaceQuickSortPartition): обе части [begin; left) и [left; end) непусты
+        const auto pivot_value = *middle;
+        RandomAccessIterator left = begin, right = last;
+        while (true) {
+            while (comparator(*left, pivot_value))  ++left;
+            while (comparator(pivot_value, *right)) --right;
+
+            if (left < right) { ConstexprIterSwap(left, right); ++left; --right; }
+            else break;
+        }
+
+        if (left - begin < end - left) { ConstexprQuickSort(begin, left, comparator); begin = left; }
+        else                           { ConstexprQuickSort(left,  end,  comparator); end   = left; }
+    }
+}
+
+}
@@ -0,0 +1,162 @@
+#pragma once
+#include <algorithm>
+#include <iterator>
+#include <vector>
+#include <future>
+#include <thread>
+
+namespace incremental_merge {
+
+// Функция галопирующего (экспоненциального) поиска upper_bound в отсортированном полуинтервале [begin; end),
+// начиная с его правого края: шаг поиска удваивается, покуда элементы больше value, после чего в найденном
+// окне выполняется обычный бинарный поиск (O(log D), где D - расстояние от end до искомой позиции)
+template <typename RandomAccessIterator, typename Type, typename Comparator>
+RandomAccessIterator GallopUpperBoundFromEnd(RandomAccessIterator begin, RandomAccessIterator end, const Type& value, Comparator comparator) {
+    using namespace std;
+
+    const auto range_length = distance(begin, end);
+
+    // Все элементы в [end - prev_offset; end) заведомо больше value
+    decltype(distance(begin, end)) prev_offset = 0, offset = 1;
+    while (offset <= range_length && comparator(value, *(end - offset))) {
+        prev_offset = offset;
+        offset *= 2;
+    }
+
+    // Искомая позиция находится в окне [end - offset; end - prev_offset]
+    return upper_bound(end - min(offset, range_length), end - prev_offset, value, comparator);
+}
+
+// Функция галопирующего (экспоненциального) поиска lower_bound в отсортированном полуинтервале [begin; end),
+// начиная с его левого края (O(log D), где D - расстояние от begin до искомой позиции)
+template <typename RandomAccessIterator, typename Type, typename Comparator>
+RandomAccessIterator GallopLowerBoundFromBegin(RandomAccessIterator begin, RandomAccessIterator end, const Type& value, Comparator comparator) {
+    using namespace std;
+
+    const auto range_length = distance(begin, end);
+
+    // Все элементы в [begin; begin + prev_offset) заведомо меньше value
+    decltype(distance(begin, end)) prev_offset = 0, offset = 1;
+    while (offset <= range_length && comparator(*(begin + (offset - 1)), value)) {
+        prev_offset = offset;
+        offset *= 2;
+    }
+
+    // Искомая позиция находится в окне [begin + prev_offset; begin + offset)
+    return lower_bound(begin + prev_offset, begin + min(offset, range_length), value, comparator);
+}
+
+// Функция слияния небольшой порции обновлений delta с большим отсортированным вектором base без его пересортировки:
+// delta сортируется, после чего сливается в base с конца на месте. Для каждого элемента delta позиция вставки
+// ищется галопированием от предыдущей, а куски base между позициями вставки сдвигаются одним move_backward,
+// так что стоимость O(M log(N / M)) сравнений плюс один линейный сдвиг вместо O(N log N) полной сортировки
+// (слияние стабильное: равные элементы из base остаются перед элементами из delta)
+template <typename Type, typename Comparator = std::less<Type>>
+void MergeDelta(std::vector<Type>& base, std::vector<Type> delta, Comparator comparator = Comparator()) {
+    using namespace std;
+
+    if (delta.empty()) return;
+
+    // Сортируем порцию обновлений
+    stable_sort(delta.begin(), delta.end(), comparator);
+
+    const size_t base_size = base.size();
+
+    // Расширяем base под новые элементы (элементы base остаются в начале)
+    base.resize(base_size + delta.size());
+
+    auto base_end = base.begin() + base_size; // Конец ещё не обработанной части base
+    auto write    = base.end();               // Позиция, левее которой записываем результат
+
+    // Идём по delta с конца: каждый элемент встаёт после всех не больших его элементов base
+    for (auto delta_it = delta.rbegin(); delta_it != delta.rend(); ++delta_it) {
+        auto position = GallopUpperBoundFromEnd(base.begin(), base_end, *delta_it, comparator);
+
+        write = move_backward(position, base_end, write); // Сдвигаем кусок base на своё место
+        *(--write) = move(*delta_it);                     // Записываем элемент delta перед ним
+
+        base_end = position;
+    }
+}
+
+// Функция удаления из большого отсортированного вектора base элементов из порции removals (каждый элемент
+// removals удаляет одно равное ему вхождение, отсутствующие элементы игнорируются). Позиции удаляемых элементов
+// ищутся галопированием слева направо, а куски между ними сдвигаются одним move, так что стоимость
+// O(M log(N / M)) сравнений плюс один линейный сдвиг. Возвращает количество удалённых элементов
+template <typename Type, typename Comparator = std::less<Type>>
+size_t RemoveSorted(std::vector<Type>& base, std::vector<Type> removals, Comparator comparator = Comparator()) {
+    using namespace std;
+
+    if (removals.empty()) return 0u;
+
+    // Сортируем порцию удалений
+    sort(removals.begin(), removals.end(), comparator);
+
+    auto read  = base.begin(); // Начало ещё не обработанной части base
+    auto write = base.begin(); // Позиция, с которой записываем оставшиеся элементы
+
+    for (const Type& value : removals) {
+        auto position = GallopLowerBoundFromBegin(read, base.end(), value, comparator);
+
+        // Сдвигаем кусок base до найденной позиции влево
+        write = (write == read) ? position : move(read, position, write);
+        read  = position;
+
+        // Если элемент найден, пропускаем его
+        if (read != base.end() && !comparator(value, *read)) ++read;
+    }
+
+    // Сдвигаем остаток и обрезаем вектор
+    write = (write == read) ? base.end() : move(read, base.end(), write);
+
+    const size_t removed = static_cast<size_t>(distance(write, base.end()));
+    base.erase(write, base.end());
+
+    return removed;
+}
+
+// Параллельная версия MergeDelta для больших порций обновлений: отсортированная delta разбивается на куски по
+// числу ядер, для начала каждого куска бинарным поиском находится соответствующая позиция в base, после чего
+// получившиеся независимые сегменты сливаются std::merge параллельно с помощью std::async в буфер scratch
+// (буфер передаётся снаружи, чтобы переиспользовать его память между тиками), который затем меняется с base
+template <typename Type, typename Comparator = std::less<Type>>
+void MergeDeltaParallel(std::vector<Type>& base, std::vector<Type> delta, std::vector<Type>& scratch, Comparator comparator = Comparator()) {
+    using namespace std;
+
+    if (delta.empty()) return;
+
+    // Сортируем порцию обновлений
+    stable_sort(delta.begin(), delta.end(), comparator);
+
+    const size_t segments = max<size_t>(1u, min<size_t>(thread::hardware_concurrency(), delta.size()));
+
+    // Границы сегментов в delta и base: элемент delta[d] встаёт после всех не больших его элементов base,
+    // так что сегменту, начинающемуся с delta[d], соответствует начало upper_bound(base, delta[d])
+    vector<size_t> delta_bounds(segments + 1u), base_bounds(segments + 1u);
+    for (size_t segment = 0u; segment < segments; ++segment) {
+        delta_bounds[segment] = delta.size() * segment / segments;
+        base_bounds[segment]  = segment == 0u ? 0u :
+            static_cast<size_t>(upper_bound(base.begin(), base.end(), delta[delta_bounds[segment]], comparator) - base.begin());
+    }
+    delta_bounds[segments] = delta.size();
+    base_bounds[segments]  = base.size();
+
+    scratch.resize(base.size() + delta.size());
+
+    // Задача (лямбда) по слиянию одного сегмента в его позицию в scratch
+    auto merge_task = [&](size_t segment) {
+        merge(base.begin()  + base_bounds[segment],  base.begin()  + base_bounds[segment + 1u],
+              delta.begin() + delta_bounds[segment], delta.begin() + delta_bounds[segment + 1u],
+              scratch.begin() + base_bounds[segment] + delta_bounds[segment], comparator);
+    };
+
+    // Сливаем все сегменты, кроме первого, параллельно, а первый - в текущем потоке
+    vector<future<void>> futures;
+    for (size_t segment = 1u; segment < segments; ++segment) futures.push_back(async(launch::async, merge_task, segment));
+    merge_task(0u);
+    for (auto& f : futures) f.get();
+
+    base.swap(scratch);
+}
+
+}
\ No newline at end of file
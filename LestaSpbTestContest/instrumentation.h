@@ -0,0 +1,267 @@
+#pragma once
+#include <iostream>
+#include <string>
+#include <array>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+#include <algorithm>
+
+// Инструментирование сортировок и деков счётчиками (сравнения, перемещения элементов, аллокации, запуски
+// std::async, глубина рекурсии, время на каждом уровне рекурсии, реаллокации дека и т.д.)
+//
+// Включается только при сборке с определённым макросом ENABLE_INSTRUMENTATION (например, -DENABLE_INSTRUMENTATION),
+// иначе все макросы INSTRUMENTATION_* раскрываются в ветки под ложной константой ENABLED: их аргументы всё равно
+// компилируются (и не могут незаметно устареть), но код счётчиков выбрасывается компилятором и не влияет на
+// производительность
+//
+// Каждый поток пишет только в свои счётчики (без атомарных read-modify-write операций и без разделения кэш-линий
+// с другими потоками), а функция TakeSnapshot() суммирует счётчики всех потоков, в том числе уже завершившихся
+
+namespace instrumentation {
+
+// Включено ли инструментирование
+#ifdef ENABLE_INSTRUMENTATION
+constexpr bool ENABLED = true;
+#else
+constexpr bool ENABLED = false;
+#endif
+
+// Суммируемые счётчики
+enum class Counter {
+    COMPARISONS,         // Количество сравнений в сортировках
+    ELEMENT_MOVES,       // Количество перемещений (копирований) элементов в сортировках
+    HEAP_ALLOCATIONS,    // Количество аллокаций в heap'е в сортировках
+    ASYNC_TASKS,         // Количество задач, запущенных в сортировках через std::async
+    DEQUE_REALLOCATIONS, // Количество реаллокаций буфера динамического дека
+    DEQUE_BYTES_MOVED,   // Количество байт, перемещённых при реаллокациях буфера динамического дека
+    COUNT
+};
+
+// Счётчики, по которым берётся максимум
+enum class Maximum {
+    RECURSION_DEPTH,       // Максимальная глубина рекурсии сортировок
+    DEQUE_HIGH_WATER_MARK, // Максимальный размер динамического дека
+    COUNT
+};
+
+// Количество уровней рекурсии, для которых учитывается время
+constexpr size_t MAX_LEVELS = 64u;
+
+// Снимок счётчиков, агрегированных по всем потокам
+struct Snapshot {
+    std::array<uint64_t, static_cast<size_t>(Counter::COUNT)> counters    = {};
+    std::array<uint64_t, static_cast<size_t>(Maximum::COUNT)> maximums    = {};
+    std::array<uint64_t, MAX_LEVELS>                          level_times = {}; // Накопительное время на уровнях рекурсии, нс
+
+    uint64_t operator [] (Counter counter) const { return counters[static_cast<size_t>(counter)]; }
+    uint64_t operator [] (Maximum maximum) const { return maximums[static_cast<size_t>(maximum)]; }
+};
+
+// Счётчики одного потока (выравнены по кэш-линии, чтобы потоки не мешали друг другу)
+struct alignas(64) ThreadCounters {
+    std::array<std::atomic<uint64_t>, static_cast<size_t>(Counter::COUNT)> counters    = {};
+    std::array<std::atomic<uint64_t>, static_cast<size_t>(Maximum::COUNT)> maximums    = {};
+    std::array<std::atomic<uint64_t>, MAX_LEVELS>                          level_times = {};
+
+    // Функция прибавления значения к счётчику (писатель у счётчика один - его поток, поэтому
+    // достаточно пары relaxed load/store без дорогой атомарной операции fetch_add)
+    static void add(std::atomic<uint64_t>& counter, uint64_t value) {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    // Функция обновления максимума
+    static void max(std::atomic<uint64_t>& maximum, uint64_t value) {
+        if (value > maximum.load(std::memory_order_relaxed)) maximum.store(value, std::memory_order_relaxed);
+    }
+
+    // Функция добавления счётчиков в снимок
+    void add_to(Snapshot& snapshot) const {
+        for (size_t i = 0; i < counters.size();    ++i) snapshot.counters[i]    += counters[i].load(std::memory_order_relaxed);
+        for (size_t i = 0; i < level_times.size(); ++i) snapshot.level_times[i] += level_times[i].load(std::memory_order_relaxed);
+        for (size_t i = 0; i < maximums.size();    ++i) snapshot.maximums[i] = std::max(snapshot.maximums[i], maximums[i].load(std::memory_order_relaxed));
+    }
+
+    // Функция сброса счётчиков
+    void reset() {
+        for (auto& counter : counters)    counter.store(0u, std::memory_order_relaxed);
+        for (auto& maximum : maximums)    maximum.store(0u, std::memory_order_relaxed);
+        for (auto& time    : level_times) time.store(0u, std::memory_order_relaxed);
+    }
+};
+
+// Реестр счётчиков всех потоков (мьютекс захватывается только при создании и завершении потока и при снятии снимка)
+struct Registry {
+    std::mutex                   mutex;
+    std::vector<ThreadCounters*> live;    // Счётчики работающих потоков
+    ThreadCounters               retired; // Накопленные счётчики завершившихся потоков
+
+    static Registry& instance() {
+        static Registry registry;
+        return registry;
+    }
+};
+
+// Владелец счётчиков потока: регистрирует их при создании и переносит в retired при завершении потока
+class ThreadCountersHolder {
+private:
+    ThreadCounters counters_;
+
+public:
+    ThreadCountersHolder() {
+        Registry& registry = Registry::instance();
+        std::lock_guard<std::mutex> guard(registry.mutex);
+        registry.live.push_back(&counters_);
+    }
+
+    ThreadCountersHolder(const ThreadCountersHolder&) = delete;
+    ThreadCountersHolder& operator = (const ThreadCountersHolder&) = delete;
+
+    ~ThreadCountersHolder() {
+        Registry& registry = Registry::instance();
+        std::lock_guard<std::mutex> guard(registry.mutex);
+
+        Snapshot snapshot;
+        counters_.add_to(snapshot);
+        for (size_t i = 0; i < snapshot.counters.size();    ++i) ThreadCounters::add(registry.retired.counters[i],    snapshot.counters[i]);
+        for (size_t i = 0; i < snapshot.level_times.size(); ++i) ThreadCounters::add(registry.retired.level_times[i], snapshot.level_times[i]);
+        for (size_t i = 0; i < snapshot.maximums.size();    ++i) ThreadCounters::max(registry.retired.maximums[i],    snapshot.maximums[i]);
+
+        registry.live.erase(std::find(registry.live.begin(), registry.live.end(), &counters_));
+    }
+
+    ThreadCounters& get() { return counters_; }
+};
+
+// Функция получения счётчиков текущего потока
+inline ThreadCounters& Local() {
+    thread_local ThreadCountersHolder holder;
+    return holder.get();
+}
+
+// Функция прибавления значения к счётчику текущего потока
+inline void Add(Counter counter, uint64_t value) {
+    ThreadCounters::add(Local().counters[static_cast<size_t>(counter)], value);
+}
+
+// Функция обновления максимума текущего потока
+inline void Max(Maximum maximum, uint64_t value) {
+    ThreadCounters::max(Local().maximums[static_cast<size_t>(maximum)], value);
+}
+
+// Функция снятия снимка счётчиков, агрегированных по всем потокам
+inline Snapshot TakeSnapshot() {
+    Registry& registry = Registry::instance();
+    std::lock_guard<std::mutex> guard(registry.mutex);
+
+    Snapshot snapshot;
+    registry.retired.add_to(snapshot);
+    for (const ThreadCounters* counters : registry.live) counters->add_to(snapshot);
+
+    return snapshot;
+}
+
+// Функция сброса счётчиков всех потоков
+//
+// Вызывать её можно только тогда, когда другие инструментированные потоки простаивают (например, между
+// замерами, после завершения всех задач сортировки): поток обновляет свой счётчик парой load/store без
+// атомарного read-modify-write, так что сброс, совпавший с обновлением, будет затёрт старым значением
+// плюс приращение, и снимок окажется несогласованным
+inline void Reset() {
+    Registry& registry = Registry::instance();
+    std::lock_guard<std::mutex> guard(registry.mutex);
+
+    registry.retired.reset();
+    for (ThreadCounters* counters : registry.live) counters->reset();
+}
+
+// Класс замера времени на уровне рекурсии depth (время записывается при выходе из области видимости)
+//
+// Время накопительное: в него входит и время вложенных уровней (в том числе ожидание задач std::async), поэтому
+// времена разных уровней нельзя складывать - каждое из них показывает, сколько заняли вызовы этой глубины
+// целиком. Суммы по уровню берутся по всем вызовам и всем потокам, так что при параллельной работе они могут
+// превышать общее время сортировки
+class LevelTimer {
+private:
+    std::chrono::steady_clock::time_point start_ = std::chrono::steady_clock::now();
+    size_t level_ = 0u;
+
+public:
+    explicit LevelTimer(int depth) : level_(std::min(static_cast<size_t>(depth), MAX_LEVELS - 1u)) {
+        Max(Maximum::RECURSION_DEPTH, static_cast<uint64_t>(depth));
+    }
+
+    LevelTimer(const LevelTimer&) = delete;
+    LevelTimer& operator = (const LevelTimer&) = delete;
+
+    ~LevelTimer() {
+        using namespace std::chrono;
+        const auto elapsed = duration_cast<nanoseconds>(steady_clock::now() - start_).count();
+        ThreadCounters::add(Local().level_times[level_], static_cast<uint64_t>(elapsed));
+    }
+};
+
+// Класс замера времени на уровне рекурсии для макроса INSTRUMENTATION_LEVEL_TIMER (при выключенном
+// инструментировании - пустой объект)
+template <bool enabled>
+class ScopedLevelTimer : public LevelTimer {
+public:
+    explicit ScopedLevelTimer(int depth) : LevelTimer(depth) {}
+};
+
+template <>
+class ScopedLevelTimer<false> {
+public:
+    explicit constexpr ScopedLevelTimer(int) noexcept {}
+};
+
+// Обёртка над компаратором, считающая количество сравнений
+template <typename Comparator>
+struct CountingComparator {
+    Comparator comparator;
+
+    template <typename Lhs, typename Rhs>
+    bool operator () (const Lhs& lhs, const Rhs& rhs) const {
+        Add(Counter::COMPARISONS, 1u);
+        return comparator(lhs, rhs);
+    }
+};
+
+// Функция оборачивания компаратора: при выключенном инструментировании возвращает его же
+template <typename Comparator>
+auto CountComparisons(Comparator comparator) {
+    if constexpr (ENABLED) return CountingComparator<Comparator>{ comparator };
+    else                   return comparator;
+}
+
+// Перегрузка оператора "<<" для вывода снимка в поток (формат "имя=значение", удобный для экспорта в метрики)
+inline std::ostream& operator << (std::ostream& os, const Snapshot& snapshot) {
+    using namespace std;
+
+    os << "comparisons="s           << snapshot[Counter::COMPARISONS]
+       << " element_moves="s        << snapshot[Counter::ELEMENT_MOVES]
+       << " heap_allocations="s     << snapshot[Counter::HEAP_ALLOCATIONS]
+       << " async_tasks="s          << snapshot[Counter::ASYNC_TASKS]
+       << " max_recursion_depth="s  << snapshot[Maximum::RECURSION_DEPTH]
+       << " deque_reallocations="s  << snapshot[Counter::DEQUE_REALLOCATIONS]
+       << " deque_bytes_moved="s    << snapshot[Counter::DEQUE_BYTES_MOVED]
+       << " deque_high_water_mark="s << snapshot[Maximum::DEQUE_HIGH_WATER_MARK];
+
+    for (size_t level = 0; level < MAX_LEVELS; ++level) {
+        if (snapshot.level_times[level]) os << " level_"s << level << "_ns="s << snapshot.level_times[level];
+    }
+
+    return os;
+}
+
+}
+
+// Макросы инструментирования (при выключенном инструментировании компилируются, но не выполняются)
+#define INSTRUMENTATION_ADD(counter, value) \
+    (::instrumentation::ENABLED ? ::instrumentation::Add(::instrumentation::Counter::counter, static_cast<uint64_t>(value)) : void())
+#define INSTRUMENTATION_MAX(maximum, value) \
+    (::instrumentation::ENABLED ? ::instrumentation::Max(::instrumentation::Maximum::maximum, static_cast<uint64_t>(value)) : void())
+#define INSTRUMENTATION_LEVEL_TIMER(depth) \
+    ::instrumentation::ScopedLevelTimer<::instrumentation::ENABLED> instrumentation_level_timer_(depth)
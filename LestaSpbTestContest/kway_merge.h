@@ -0,0 +1,277 @@
+#pragma once
+#include <algorithm>
+#include <iterator>
+#include <vector>
+#include <utility>
+#include <functional>
+#include <type_traits>
+#include <future>
+#include <thread>
+
+namespace kway_merge {
+
+// Минимальное количество элементов на поток для параллельного слияния (на меньших объёмах
+// запуск потоков и выбор границ дороже самого слияния)
+constexpr size_t PARALLEL_MERGE_MIN_SIZE_PER_THREAD = 1u << 14;
+
+// Класс источника, читающего отсортированный полуинтервал [begin; end)
+//
+// Слияние принимает любые источники с таким же интерфейсом: empty() - исчерпан ли источник, front() - текущий
+// (наименьший из оставшихся) элемент, pop() - переход к следующему элементу. Так можно сливать, например,
+// данные, поступающие по сети или читаемые из файлов порциями, не загружая их в память целиком
+template <typename Iterator>
+class IteratorRangeSource {
+private:
+    Iterator begin_;
+    Iterator end_;
+
+public:
+    explicit IteratorRangeSource(Iterator begin, Iterator end) : begin_(begin), end_(end) {}
+
+    bool empty() const { return begin_ == end_; }
+    decltype(auto) front() const { return *begin_; }
+    void pop() { ++begin_; }
+};
+
+// Класс дерева проигравших (турнирного дерева) для K-путевого слияния источников
+//
+// Листья дерева - текущие элементы источников (их количество дополняется до степени двойки исчерпанными
+// источниками), во внутренних узлах хранятся проигравшие в матче между поддеревьями, а в нулевом узле -
+// победитель всего турнира (наименьший элемент). После извлечения победителя новый элемент его источника
+// проходит путь от листа до корня, сравниваясь только с проигравшими на этом пути, так что на каждый элемент
+// результата приходится log2 K сравнений узлов (против 2 log2 K у двоичной кучи) и одна порция работы вместо
+// log2 K проходов попарных слияний
+//
+// Узлы лежат в одном непрерывном векторе и хранят копию ключа рядом с номером источника, так что подъём
+// по дереву читает только сам вектор узлов, без обращений к источникам. При равенстве элементов побеждает
+// источник с меньшим номером, поэтому слияние стабильное
+template <typename Source, typename Comparator = std::less<std::decay_t<decltype(std::declval<const Source&>().front())>>>
+class LoserTree {
+public:
+    using value_type = std::decay_t<decltype(std::declval<const Source&>().front())>;
+
+private:
+    // Узел дерева: ключ, номер источника и признак исчерпанного источника (он проигрывает всем)
+    struct Node {
+        value_type key       = {};
+        size_t     source    = 0u;
+        bool       exhausted = true;
+    };
+
+    std::vector<Source> sources_;
+    std::vector<Node>   nodes_;       // nodes_[0] - победитель, nodes_[1; leaves_) - проигравшие во внутренних узлах
+    size_t              leaves_ = 1u; // Количество листьев (степень двойки не меньше количества источников)
+    Comparator          comparator_;
+
+    // Функция сравнения узлов: меньший ключ, а при равенстве - меньший номер источника
+    bool less(const Node& lhs, const Node& rhs) const {
+        if (lhs.exhausted) return false;
+        if (rhs.exhausted) return true;
+
+        if (comparator_(lhs.key, rhs.key)) return true;
+        if (comparator_(rhs.key, lhs.key)) return false;
+
+        return lhs.source < rhs.source;
+    }
+
+    // Функция получения листа для текущего элемента источника source
+    Node leaf(size_t source) const {
+        Node node;
+        node.source = source;
+
+        if (source < sources_.size() && !sources_[source].empty()) {
+            node.key       = sources_[source].front();
+            node.exhausted = false;
+        }
+
+        return node;
+    }
+
+public:
+    explicit LoserTree(std::vector<Source> sources, Comparator comparator = Comparator()) : sources_(std::move(sources)), comparator_(comparator) {
+        while (leaves_ < sources_.size()) leaves_ *= 2u;
+        nodes_.resize(leaves_);
+
+        // Проводим начальный турнир снизу вверх: winners[node] - победитель поддерева node
+        // (листья дерева - узлы [leaves_; 2 * leaves_))
+        std::vector<Node> winners(2u * leaves_);
+        for (size_t source = 0; source < leaves_; ++source) winners[leaves_ + source] = leaf(source);
+
+        for (size_t node = leaves_ - 1u; node > 0u; --node) {
+            Node& left  = winners[2u * node];
+            Node& right = winners[2u * node + 1u];
+
+            if (less(right, left)) std::swap(left, right);
+            winners[node] = std::move(left);
+            nodes_[node]  = std::move(right);
+        }
+
+        nodes_[0] = std::move(winners[1]);
+    }
+
+    // Функция проверки, исчерпаны ли все источники
+    bool empty() const { return nodes_[0].exhausted; }
+
+    // Функция получения наименьшего элемента
+    const value_type& front() const { return nodes_[0].key; }
+
+    // Функция получения номера источника наименьшего элемента
+    size_t source() const { return nodes_[0].source; }
+
+    // Функция перехода к следующему элементу
+    void pop() {
+        const size_t source = nodes_[0].source;
+        sources_[source].pop();
+
+        // Новый элемент источника поднимается от листа к корню, уступая место тем, кто меньше него
+        Node candidate = leaf(source);
+        for (size_t node = (leaves_ + source) / 2u; node > 0u; node /= 2u) {
+            if (less(nodes_[node], candidate)) std::swap(nodes_[node], candidate);
+        }
+
+        nodes_[0] = std::move(candidate);
+    }
+
+    // Функция извлечения наименьшего элемента (перемещением из дерева) с переходом к следующему
+    value_type take() {
+        value_type value = std::move(nodes_[0].key);
+        pop();
+        return value;
+    }
+};
+
+// Функция K-путевого слияния отсортированных источников sources в output, возвращает итератор на конец результата
+template <typename Source, typename OutputIt, typename Comparator>
+OutputIt KWayMerge(std::vector<Source> sources, OutputIt output, Comparator comparator) {
+    LoserTree<Source, Comparator> tree(std::move(sources), comparator);
+
+    while (!tree.empty()) {
+        *output = tree.take();
+        ++output;
+    }
+
+    return output;
+}
+
+// Перегрузка KWayMerge со стандартным компаратором
+template <typename Source, typename OutputIt>
+OutputIt KWayMerge(std::vector<Source> sources, OutputIt output) {
+    return KWayMerge(std::move(sources), output, std::less<typename LoserTree<Source>::value_type>());
+}
+
+// Функция K-путевого слияния отсортированных полуинтервалов runs (пар итераторов) в output
+template <typename Iterator, typename OutputIt, typename Comparator>
+OutputIt KWayMerge(const std::vector<std::pair<Iterator, Iterator>>& runs, OutputIt output, Comparator comparator) {
+    std::vector<IteratorRangeSource<Iterator>> sources;
+    sources.reserve(runs.size());
+    for (const auto& [begin, end] : runs) sources.emplace_back(begin, end);
+
+    return KWayMerge(std::move(sources), output, comparator);
+}
+
+// Перегрузка KWayMerge для полуинтервалов со стандартным компаратором
+template <typename Iterator, typename OutputIt>
+OutputIt KWayMerge(const std::vector<std::pair<Iterator, Iterator>>& runs, OutputIt output) {
+    return KWayMerge(runs, output, std::less<typename std::iterator_traits<Iterator>::value_type>());
+}
+
+// Функция выбора по нескольким последовательностям (multi-sequence selection): находит для каждого
+// отсортированного полуинтервала runs[i] количество splits[i] его элементов, входящих в rank наименьших
+// элементов объединения. Элементы упорядочены по паре (значение, номер полуинтервала), так же как в LoserTree,
+// поэтому границы точные и при повторяющихся значениях, а слияние по частям совпадает со слиянием целиком
+//
+// Для каждого полуинтервала поддерживается окно [lo; hi), в котором находится граница. На каждом шаге берётся
+// средний элемент самого широкого окна, бинарными поисками находится его ранг в объединении, и по сравнению
+// ранга с rank сужаются окна всех полуинтервалов (окно выбранного - как минимум вдвое)
+template <typename RandomIt, typename Comparator>
+std::vector<size_t> MultiSequenceSelect(const std::vector<std::pair<RandomIt, RandomIt>>& runs, size_t rank, Comparator comparator) {
+    using namespace std;
+
+    const size_t runs_count = runs.size();
+    vector<size_t> lo(runs_count, 0u), hi(runs_count), positions(runs_count);
+    for (size_t i = 0; i < runs_count; ++i) hi[i] = static_cast<size_t>(distance(runs[i].first, runs[i].second));
+
+    while (true) {
+        // Выбираем самое широкое окно
+        size_t widest = runs_count;
+        for (size_t i = 0; i < runs_count; ++i) {
+            if (lo[i] < hi[i] && (widest == runs_count || hi[i] - lo[i] > hi[widest] - lo[widest])) widest = i;
+        }
+
+        // Если все окна пусты, границы найдены
+        if (widest == runs_count) return lo;
+
+        const size_t middle = lo[widest] + (hi[widest] - lo[widest]) / 2u;
+        const auto&  pivot  = runs[widest].first[middle];
+
+        // Считаем элементы, предшествующие опорному: в полуинтервалах с меньшим номером - не большие его,
+        // с большим номером - строго меньшие
+        size_t pivot_rank = 0u;
+        for (size_t i = 0; i < runs_count; ++i) {
+            const RandomIt begin = runs[i].first + lo[i], end = runs[i].first + hi[i];
+
+            if      (i < widest) positions[i] = static_cast<size_t>(upper_bound(begin, end, pivot, comparator) - runs[i].first);
+            else if (i > widest) positions[i] = static_cast<size_t>(lower_bound(begin, end, pivot, comparator) - runs[i].first);
+            else                 positions[i] = middle;
+
+            pivot_rank += positions[i];
+        }
+
+        // Если опорный элемент входит в rank наименьших, то и все предшествующие ему входят,
+        // а иначе не входят все следующие за ним
+        if (pivot_rank < rank) {
+            for (size_t i = 0; i < runs_count; ++i) lo[i] = positions[i];
+            lo[widest] = middle + 1u;
+        }
+        else {
+            for (size_t i = 0; i < runs_count; ++i) hi[i] = positions[i];
+        }
+    }
+}
+
+// Параллельная функция K-путевого слияния отсортированных полуинтервалов runs в output: результат делится на
+// threads равных частей, границы частей в каждом полуинтервале находятся выбором по нескольким
+// последовательностям, после чего каждая часть сливается деревом проигравших независимо с помощью std::async
+template <typename RandomIt, typename OutputRandomIt, typename Comparator>
+OutputRandomIt ParallelKWayMerge(const std::vector<std::pair<RandomIt, RandomIt>>& runs, OutputRandomIt output, Comparator comparator,
+                                 size_t threads = std::max(1u, std::thread::hardware_concurrency())) {
+    using namespace std;
+
+    size_t total_size = 0u;
+    for (const auto& [begin, end] : runs) total_size += static_cast<size_t>(distance(begin, end));
+
+    // Для небольших объёмов потоки не нужны
+    threads = min(threads, max<size_t>(1u, total_size / PARALLEL_MERGE_MIN_SIZE_PER_THREAD));
+    if (threads < 2u) return KWayMerge(runs, output, comparator);
+
+    // Границы частей во всех полуинтервалах (первая часть начинается с начала, последняя заканчивается в конце)
+    vector<vector<size_t>> splits(threads + 1u);
+    splits[0].assign(runs.size(), 0u);
+    for (size_t i = 0; i < runs.size(); ++i) splits[threads].push_back(static_cast<size_t>(distance(runs[i].first, runs[i].second)));
+    for (size_t part = 1; part < threads; ++part) splits[part] = MultiSequenceSelect(runs, total_size * part / threads, comparator);
+
+    // Сливаем части параллельно (последнюю - в текущем потоке)
+    auto merge_part = [&runs, &splits, output, comparator, total_size, threads](size_t part) {
+        vector<pair<RandomIt, RandomIt>> part_runs;
+        part_runs.reserve(runs.size());
+        for (size_t i = 0; i < runs.size(); ++i) part_runs.emplace_back(runs[i].first + splits[part][i], runs[i].first + splits[part + 1u][i]);
+
+        KWayMerge(part_runs, output + total_size * part / threads, comparator);
+    };
+
+    vector<future<void>> futures;
+    for (size_t part = 0; part + 1u < threads; ++part) futures.push_back(async(launch::async, merge_part, part));
+    merge_part(threads - 1u);
+
+    for (auto& f : futures) f.get();
+
+    return output + total_size;
+}
+
+// Перегрузка ParallelKWayMerge со стандартным компаратором
+template <typename RandomIt, typename OutputRandomIt>
+OutputRandomIt ParallelKWayMerge(const std::vector<std::pair<RandomIt, RandomIt>>& runs, OutputRandomIt output) {
+    return ParallelKWayMerge(runs, output, std::less<typename std::iterator_traits<RandomIt>::value_type>());
+}
+
+}
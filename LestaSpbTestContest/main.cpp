@@ -1,14 +1,84 @@
 #include <iostream>
 #include <vector>
+#include <deque>
+#include <array>
 #include <cassert>
 #include <numeric>
 #include <algorithm>
+#include <thread>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+#include <chrono>
+#include <future>
+#include <functional>
+#include <cmath>
 
 #include "is_even.h"                   // Задание 1
 #include "static_ring_buffer_deque.h"  // Задание 2
 #include "dynamic_ring_buffer_deque.h" // Задание 2
 #include "merge_sort.h"                // Задание 3
 #include "in_place_quick_sort.h"       // Задание 3
+#include "quick_select.h"
+#include "incremental_merge.h"
+#include "instrumentation.h"
+#include "flight_recorder.h"
+#include "mapped_ring_buffer_deque.h"
+#include "string_sort.h"
+#include "resumable_sort.h"
+#include "async_sort.h"
+#include "segmented_ring_buffer_deque.h"
+#include "perf_counters.h"
+#include "sliding_window.h"
+#include "kway_merge.h"
+#include "adaptive_sort.h"
+
+#if defined(__cpp_impl_coroutine) && defined(__cpp_lib_jthread)
+// Простейший тип корутины для тестирования AsyncSort: начинает выполняться сразу и никого не ждёт по завершении
+struct TestCoroutine {
+	struct promise_type {
+		TestCoroutine get_return_object() { return {}; }
+		std::suspend_never initial_suspend() noexcept { return {}; }
+		std::suspend_never final_suspend() noexcept { return {}; }
+		void return_void() { }
+		void unhandled_exception() { std::terminate(); }
+	};
+};
+
+// Корутина, которая асинхронно сортирует values и сообщает результат co_await через done
+TestCoroutine SortValuesAsync(std::vector<int>& values, std::promise<bool>& done, std::stop_token stop_token) {
+	// Исполнитель: каждая задача в отдельном потоке (в реальном коде - пул потоков или очередь цикла событий)
+	auto executor = [](std::function<void()> task) { std::thread(std::move(task)).detach(); };
+
+	done.set_value(co_await async_sort::AsyncSort(values.begin(), values.end(), executor, std::move(stop_token)));
+}
+
+// Корутина, которая асинхронно сортирует values компаратором, выбрасывающим исключение на значении failing_value,
+// и передаёт исключение из co_await через done
+TestCoroutine SortValuesThrowingAsync(std::vector<int>& values, std::promise<bool>& done, int failing_value) {
+	auto executor = [](std::function<void()> task) { std::thread(std::move(task)).detach(); };
+	auto comparator = [failing_value](int lhs, int rhs) {
+		if (lhs == failing_value || rhs == failing_value) throw std::runtime_error("comparator failure");
+		return lhs < rhs;
+	};
+
+	try {
+		done.set_value(co_await async_sort::AsyncSort(values.begin(), values.end(), executor, std::stop_token(), comparator));
+	}
+	catch (...) {
+		done.set_exception(std::current_exception());
+	}
+}
+#endif
+
+// Ключ, упорядоченный только оператором "<" (без оператора "=="), для тестирования adaptive_sort
+struct LessOnlyKey {
+	int key = 0;
+	int id  = 0;
+
+	bool operator < (const LessOnlyKey& other) const { return key < other.key; }
+};
 
 int main() {
 	using namespace std;
@@ -171,6 +241,49 @@ int main() {
 		cout << ring << endl;
 	}
 
+	// Тестирование сегментированного дека с ограниченной задержкой роста
+	{
+		using namespace segmented_ring_buffer_deque;
+
+		cout << endl << "SegmentedRingBufferDeque testing"s << endl;
+
+		// Маленькие блоки, чтобы проверить переходы через границы блоков
+		SegmentedRingBufferDeque<int, 2> ring;
+		assert(ring.empty());
+
+		// Попытка вызова pop_back/pop_front из пустого дека должна привести к вызову исключения
+		try { ring.pop_front(); assert(false); }
+		catch (const out_of_range&) { }
+		catch (...) { assert(false); }
+
+		// Добавляем элементы
+		ring.push_back(3);
+		ring.push_front(2);
+		ring.push_back(4);
+		ring.push_front(1);
+		ring.push_back(5);
+
+		// Проверим, что элементы добавлены правильно
+		assert(ring.size() == 5u);
+		assert(ring[0] == 1 && ring[1] == 2 && ring[2] == 3 && ring[3] == 4 && ring[4] == 5);
+
+		cout << ring << endl;
+
+		// Удалим крайние элементы
+		assert(ring.pop_front() == 1);
+		assert(ring.pop_back() == 5);
+		assert(ring.size() == 3u && ring[0] == 2 && ring[1] == 3 && ring[2] == 4);
+
+		cout << ring << endl;
+
+		// Большой дек: элементы при росте не перемещаются, а порядок сохраняется
+		SegmentedRingBufferDeque<int> big;
+		big.reserve(100000);
+		for (int i = 0; i < 100000; ++i) big.push_back(i);
+		for (int i = 0; i < 50000; ++i) assert(big.pop_front() == i);
+		assert(big.size() == 50000u && big[0] == 50000 && big[49999] == 99999);
+	}
+
 	// Задание 3
 	// Тестирование параллельной версии merge sort
 	{
@@ -185,6 +298,41 @@ int main() {
 		cout << endl;
 	}
 
+	// Тестирование параллельной сортировки слиянием на месте с ограниченным буфером
+	{
+		using namespace merge_sort;
+
+		cout << endl << "MergeSortInPlace testing"s << endl;
+
+		// Пары (ключ, исходная позиция) для проверки стабильности: сравниваются только ключи
+		struct Entry {
+			int key = 0;
+			int position = 0;
+			bool operator < (const Entry& rhs) const { return key < rhs.key; }
+		};
+
+		vector<Entry> source(1000);
+		for (size_t i = 0; i < source.size(); ++i) source[i] = { static_cast<int>((i * 7919u) % 37u), static_cast<int>(i) };
+
+		vector<Entry> expected(source);
+		stable_sort(expected.begin(), expected.end());
+
+		// Без буфера, с буфером порядка sqrt(N) и с буфером на половину диапазона результат одинаковый и стабильный
+		for (size_t scratch_size : { size_t(0), size_t(32), source.size() / 2u }) {
+			vector<Entry> values(source);
+			MergeSortInPlace(values.begin(), values.end(), scratch_size);
+			assert(equal(values.begin(), values.end(), expected.begin(), [](const Entry& lhs, const Entry& rhs) {
+				return lhs.key == rhs.key && lhs.position == rhs.position;
+			}));
+		}
+
+		vector<int> values({ 42, -9, 15, 3, -21, 95, 38, 17, -30, 12, 19, 44, 0, 24, 15, 68, 21, -49, -51 });
+		MergeSortInPlace(values.begin(), values.end(), 0u);
+
+		for (const auto& e : values) cout << e << " "s;
+		cout << endl;
+	}
+
 	// Задание 3
 	// Тестирование параллельной версии in-place quick sort
 	{
@@ -199,5 +347,701 @@ int main() {
 		cout << endl;
 	}
 
+	// Тестирование параллельного разбиения для верхних уровней in-place quick sort
+	{
+		using namespace in_place_quick_sort;
+
+		cout << endl << "ParallelPartition testing"s << endl;
+
+		vector<int> values(100000);
+		for (size_t i = 0; i < values.size(); ++i) values[i] = static_cast<int>((i * 7919u) % 1000u);
+
+		const size_t expected_boundary = static_cast<size_t>(count_if(values.begin(), values.end(), [](int e) { return e < 300; }));
+
+		// Разбиение на 7 блоков: все элементы меньше 300 должны оказаться левее границы
+		auto boundary = ParallelPartition(values.begin(), values.end(), [](int e) { return e < 300; }, 7u);
+		assert(static_cast<size_t>(boundary - values.begin()) == expected_boundary);
+		assert(all_of(values.begin(), boundary, [](int e) { return e < 300; }));
+		assert(none_of(boundary, values.end(), [](int e) { return e < 300; }));
+
+		cout << "boundary: "s << expected_boundary << endl;
+
+		// Сортировка большого массива (на многоядерной машине верхние уровни разбиваются параллельно),
+		// в том числе массива из одинаковых элементов
+		InPlaceQuickSort(values.begin(), values.end());
+		assert(is_sorted(values.begin(), values.end()));
+
+		vector<int> equal_values(200000, 42);
+		InPlaceQuickSort(equal_values.begin(), equal_values.end());
+		assert(all_of(equal_values.begin(), equal_values.end(), [](int e) { return e == 42; }));
+	}
+
+	// Тестирование выборки n-го элемента, частичной сортировки и получения K лучших элементов
+	{
+		using namespace quick_select;
+
+		cout << endl << "QuickSelect testing"s << endl;
+
+		const vector<int> source({ 42, -9, 15, 3, -21, 95, 38, 17, -30, 12, 19, 44, 0, 24, 15, 68, 21, -49, -51 });
+
+		vector<int> sorted_values(source);
+		sort(sorted_values.begin(), sorted_values.end());
+
+		// n-й элемент должен совпасть с элементом отсортированного массива на каждой позиции
+		for (size_t n = 0; n < source.size(); ++n) {
+			vector<int> values(source);
+			NthElement(values.begin(), values.begin() + n, values.end());
+			assert(values[n] == sorted_values[n]);
+			assert(all_of(values.begin(), values.begin() + n, [&](int e) { return e <= values[n]; }));
+			assert(all_of(values.begin() + n, values.end(), [&](int e) { return e >= values[n]; }));
+		}
+
+		// Частичная сортировка первых 5 элементов
+		vector<int> values(source);
+		PartialSort(values.begin(), values.begin() + 5, values.end());
+		assert(equal(values.begin(), values.begin() + 5, sorted_values.begin()));
+
+		for (auto it = values.begin(); it != values.begin() + 5; ++it) cout << *it << " "s;
+		cout << endl;
+
+		// Выборка на большом массиве (в том числе упорядоченном, где опорный средний элемент был бы медианой,
+		// и с большим количеством повторов)
+		vector<int> big(100000);
+		for (size_t i = 0; i < big.size(); ++i) big[i] = static_cast<int>((i * 7919u) % 1000u);
+		vector<int> big_sorted(big);
+		sort(big_sorted.begin(), big_sorted.end());
+
+		NthElement(big.begin(), big.begin() + 50000, big.end());
+		assert(big[50000] == big_sorted[50000]);
+
+		// K лучших элементов (наибольших) из потока
+		const vector<int> top = TopK(big_sorted.begin(), big_sorted.end(), 10u, greater<int>());
+		assert(top.size() == 10u);
+		assert(equal(top.begin(), top.end(), big_sorted.rbegin()));
+
+		for (const auto& e : TopK(source.begin(), source.end(), 3u, greater<int>())) cout << e << " "s;
+		cout << endl;
+	}
+
+	// Тестирование слияния порции обновлений с большим отсортированным массивом
+	{
+		using namespace incremental_merge;
+
+		cout << endl << "IncrementalMerge testing"s << endl;
+
+		vector<int> base({ -51, -30, -9, 0, 12, 15, 19, 24, 42, 68 });
+		const vector<int> delta({ 95, -49, 15, 3, 21 });
+
+		// Последовательное слияние на месте
+		vector<int> merged(base);
+		MergeDelta(merged, delta);
+		assert(is_sorted(merged.begin(), merged.end()));
+		assert(merged.size() == base.size() + delta.size());
+
+		for (const auto& e : merged) cout << e << " "s;
+		cout << endl;
+
+		// Параллельное слияние через буфер должно дать тот же результат
+		vector<int> scratch;
+		vector<int> merged_parallel(base);
+		MergeDeltaParallel(merged_parallel, delta, scratch);
+		assert(merged_parallel == merged);
+
+		// Удаление: отсутствующий элемент (404) игнорируется, из двух 15 удаляется одна
+		assert(RemoveSorted(merged, { 15, 95, -51, 404 }) == 3u);
+		assert(merged == vector<int>({ -49, -30, -9, 0, 3, 12, 15, 19, 21, 24, 42, 68 }));
+
+		for (const auto& e : merged) cout << e << " "s;
+		cout << endl;
+	}
+
+	// Тестирование счётчиков инструментирования (включаются макросом ENABLE_INSTRUMENTATION)
+	{
+		cout << endl << "Instrumentation testing"s << endl;
+
+		instrumentation::Reset();
+
+		vector<int> values({ 42, -9, 15, 3, -21, 95, 38, 17, -30, 12, 19, 44, 0, 24, 15, 68, 21, -49, -51 });
+		merge_sort::MergeSort(values.begin(), values.end());
+		in_place_quick_sort::InPlaceQuickSort(values.begin(), values.end());
+
+		dynamic_ring_buffer_deque::DynamicRingBufferDeque<int> ring;
+		for (int i = 0; i < 100; ++i) ring.push_back(i);
+
+		const instrumentation::Snapshot snapshot = instrumentation::TakeSnapshot();
+
+		// Обе ветки компилируются в любой сборке, а выполняется та, что соответствует ENABLE_INSTRUMENTATION
+		if (instrumentation::ENABLED) {
+			// Счётчики должны учесть работу и в основном потоке, и в потоках std::async
+			assert(snapshot[instrumentation::Counter::COMPARISONS] > 0u);
+			assert(snapshot[instrumentation::Counter::ELEMENT_MOVES] > 0u);
+			assert(snapshot[instrumentation::Counter::HEAP_ALLOCATIONS] == values.size() - 1u);
+			assert(snapshot[instrumentation::Counter::ASYNC_TASKS] > 0u);
+			assert(snapshot[instrumentation::Maximum::RECURSION_DEPTH] > 0u);
+			assert(snapshot[instrumentation::Counter::DEQUE_REALLOCATIONS] == 8u); // 1, 2, 4, ..., 128
+			assert(snapshot[instrumentation::Maximum::DEQUE_HIGH_WATER_MARK] == 100u);
+		}
+		else {
+			// При выключенном инструментировании счётчики не меняются
+			assert(snapshot[instrumentation::Counter::COMPARISONS] == 0u);
+			assert(snapshot[instrumentation::Counter::DEQUE_REALLOCATIONS] == 0u);
+		}
+
+		// Счётчики можно вызывать напрямую и без макроса ENABLE_INSTRUMENTATION (так проверяется, что код
+		// инструментирования компилируется и работает в любой сборке)
+		{
+			instrumentation::Reset();
+
+			const auto less = instrumentation::CountingComparator<std::less<int>>{ std::less<int>() };
+			assert(less(1, 2) && !less(2, 1));
+			{ instrumentation::LevelTimer timer(3); }
+			instrumentation::Add(instrumentation::Counter::ELEMENT_MOVES, 5u);
+
+			const instrumentation::Snapshot direct = instrumentation::TakeSnapshot();
+			assert(direct[instrumentation::Counter::COMPARISONS] == 2u && direct[instrumentation::Counter::ELEMENT_MOVES] == 5u);
+			assert(direct[instrumentation::Maximum::RECURSION_DEPTH] == 3u);
+		}
+
+		cout << snapshot << endl;
+	}
+
+	// Тестирование скользящих агрегатов на кольцевых буферах
+	{
+		using namespace sliding_window;
+
+		cout << endl << "SlidingWindow testing"s << endl;
+
+		SlidingWindowMin<int, 3> window_min;
+		SlidingWindowMax<int, 3> window_max;
+		SlidingWindowAggregate<int, 3> window_sum;
+		SlidingWindowStatistics<int, 3> window_statistics;
+
+		// Окно из трёх последних значений
+		const vector<int> values({ 5, 1, 4, 2, 8, 3, 3, 9 });
+		const vector<int> expected_min({ 5, 1, 1, 1, 2, 2, 3, 3 });
+		const vector<int> expected_max({ 5, 5, 5, 4, 8, 8, 8, 9 });
+		const vector<int> expected_sum({ 5, 6, 10, 7, 14, 13, 14, 15 });
+
+		for (size_t i = 0; i < values.size(); ++i) {
+			window_min.push(values[i]);
+			window_max.push(values[i]);
+			window_sum.push(values[i]);
+			window_statistics.push(values[i]);
+
+			assert(window_min.value() == expected_min[i]);
+			assert(window_max.value() == expected_max[i]);
+			assert(window_sum.aggregate() == expected_sum[i]);
+			assert(window_statistics.size() == min<size_t>(i + 1u, 3u));
+		}
+
+		// Окно { 3, 3, 9 }: среднее 5, дисперсия 8
+		assert(abs(window_statistics.mean() - 5.0) < 1e-9);
+		assert(abs(window_statistics.variance() - 8.0) < 1e-9);
+
+		// Любая ассоциативная операция, в том числе некоммутативная (конкатенация сохраняет порядок значений)
+		auto concatenate = [](const string& lhs, const string& rhs) { return lhs + rhs; };
+		SlidingWindowAggregate<string, 3, decltype(concatenate)> window_concatenation(concatenate);
+		for (const string& word : { "a"s, "b"s, "c"s, "d"s }) window_concatenation.push(word);
+		assert(window_concatenation.aggregate() == "bcd"s);
+
+		// Пакетное добавление: из пачки обрабатываются только значения, попадающие в окно
+		vector<int> batch(100000);
+		iota(batch.begin(), batch.end(), 0);
+		window_min.push(batch.begin(), batch.end());
+		window_sum.push(batch.begin(), batch.end());
+		window_statistics.push(batch.begin(), batch.end());
+		assert(window_min.value() == 99997);
+		assert(window_sum.aggregate() == 99997 + 99998 + 99999);
+		assert(window_statistics.mean() == 99998.0);
+
+		cout << "min: "s << window_min.value() << ", sum: "s << window_sum.aggregate() << ", mean: "s << window_statistics.mean()
+			 << ", standard deviation: "s << window_statistics.standard_deviation() << endl;
+	}
+
+	// Тестирование K-путевого слияния деревом проигравших
+	{
+		using namespace kway_merge;
+
+		cout << endl << "KWayMerge testing"s << endl;
+
+		// Отсортированные отрезки, например, результаты сортировки на разных потоках
+		vector<vector<int>> runs({ { 3, 8, 15, 42 }, { -9, 0, 17 }, { }, { 1, 2, 3, 4, 5 }, { 15, 15, 99 } });
+
+		vector<pair<vector<int>::const_iterator, vector<int>::const_iterator>> ranges;
+		for (const auto& run : runs) ranges.emplace_back(run.cbegin(), run.cend());
+
+		vector<int> merged;
+		KWayMerge(ranges, back_inserter(merged));
+
+		vector<int> expected;
+		for (const auto& run : runs) expected.insert(expected.end(), run.begin(), run.end());
+		sort(expected.begin(), expected.end());
+		assert(merged == expected);
+
+		// Параллельное слияние: 64 отрезка, результат делится между потоками выбором по нескольким последовательностям
+		vector<int> values(1u << 20);
+		for (size_t i = 0; i < values.size(); ++i) values[i] = static_cast<int>((i * 2654435761u) % 1000u);
+
+		vector<pair<vector<int>::iterator, vector<int>::iterator>> value_runs;
+		for (size_t run = 0; run < 64u; ++run) {
+			const auto begin = values.begin() + run * (values.size() / 64u), end = begin + values.size() / 64u;
+			sort(begin, end);
+			value_runs.emplace_back(begin, end);
+		}
+
+		vector<int> parallel_merged(values.size());
+		ParallelKWayMerge(value_runs, parallel_merged.begin(), less<int>(), 4u);
+		assert(is_sorted(parallel_merged.begin(), parallel_merged.end()));
+
+		// Границы выбора точны и при повторяющихся значениях
+		const vector<size_t> splits = MultiSequenceSelect(value_runs, values.size() / 2u, less<int>());
+		assert(accumulate(splits.begin(), splits.end(), size_t{ 0 }) == values.size() / 2u);
+
+		for (const auto& e : merged) cout << e << " "s;
+		cout << endl;
+	}
+
+	// Тестирование адаптивного выбора алгоритма сортировки
+	{
+		using namespace adaptive_sort;
+
+		cout << endl << "AdaptiveSort testing"s << endl;
+
+		// Каждое решение передаётся в журнал
+		size_t logged = 0u;
+		SetLogger([&logged](const SortDecision& decision) { ++logged; cout << decision << endl; });
+
+		vector<int> small({ 42, -9, 15, 3, -21 });
+		const SortDecision small_decision = Sort(small);
+		assert(small_decision.algorithm == Algorithm::INSERTION_SORT && small_decision.runs == 4u);
+
+		vector<int> values(1u << 16);
+		iota(values.begin(), values.end(), 0);
+		assert(Sort(values).algorithm == Algorithm::NONE);
+
+		reverse(values.begin(), values.end());
+		assert(Sort(values).algorithm == Algorithm::REVERSE);
+		assert(is_sorted(values.begin(), values.end()));
+
+		// Почти отсортированные данные: несколько отсортированных отрезков сливаются за один проход
+		rotate(values.begin(), values.begin() + 1000, values.end());
+		assert(Sort(values).algorithm == Algorithm::RUN_MERGE);
+		assert(is_sorted(values.begin(), values.end()));
+
+		// Перемешанные целые числа сортируются поразрядно
+		for (size_t i = 0; i < values.size(); ++i) values[i] = static_cast<int>((i * 2654435761u) % 100003u) - 50000;
+		assert(StableSort(values).algorithm == Algorithm::RADIX_SORT);
+		assert(is_sorted(values.begin(), values.end()));
+
+		// Для остальных типов выбирается сортировка сравнениями (последовательная или параллельная)
+		vector<double> doubles(values.rbegin(), values.rend());
+		for (size_t i = 0; i < doubles.size(); i += 2u) doubles[i] = -doubles[i];
+		Sort(doubles);
+		assert(is_sorted(doubles.begin(), doubles.end()));
+
+		vector<string> strings({ "tank"s, "shot"s, "model"s, "texture"s, "sound"s });
+		Sort(strings);
+		assert(is_sorted(strings.begin(), strings.end()));
+
+		// Указатели и C-массивы тоже являются диапазонами
+		double raw_doubles[100];
+		for (size_t i = 0; i < 100u; ++i) raw_doubles[i] = static_cast<double>((i * 37u) % 100u) - 50.0;
+		Sort(raw_doubles, raw_doubles + 100);
+		assert(is_sorted(raw_doubles, raw_doubles + 100));
+
+		string raw_strings[5] = { "tank"s, "shot"s, "model"s, "texture"s, "sound"s };
+		StableSort(raw_strings);
+		assert(is_sorted(begin(raw_strings), end(raw_strings)));
+
+		// Достаточно оператора "<": равные ключи различаются только по id, а стабильная сортировка сохраняет их порядок
+		vector<LessOnlyKey> keys(1000u);
+		for (size_t i = 0; i < keys.size(); ++i) keys[i] = { static_cast<int>((i * 7919u) % 13u), static_cast<int>(i) };
+		vector<LessOnlyKey> few_keys(keys.begin(), keys.begin() + 10);
+
+		assert(StableSort(keys).duplicate_ratio > 0.9);
+		assert(StableSort(few_keys).algorithm == Algorithm::INSERTION_SORT);
+		for (const auto* sorted_keys : { &keys, &few_keys }) {
+			assert(is_sorted(sorted_keys->begin(), sorted_keys->end()));
+			for (size_t i = 1; i < sorted_keys->size(); ++i) {
+				const LessOnlyKey& lhs = (*sorted_keys)[i - 1u], & rhs = (*sorted_keys)[i];
+				assert(lhs < rhs || lhs.id < rhs.id);
+			}
+		}
+
+		assert(logged == 11u);
+		SetLogger(nullptr);
+	}
+
+	// Тестирование вычислений на этапе компиляции: constexpr-дек и constexpr-сортировки
+	{
+		using namespace static_ring_buffer_deque;
+
+		cout << endl << "Constexpr testing"s << endl;
+
+		// Кольцо событий, заполненное на этапе компиляции
+		constexpr auto ring = [] {
+			StaticRingBufferDeque<int, 4> ring;
+			for (int i = 0; i < 6; ++i) ring.push_back_overwrite(i);
+			ring.push_front(ring.pop_back() * 10);
+			return ring;
+		}();
+		static_assert(ring.size() == 4u && ring[0] == 50 && ring[1] == 2 && ring[3] == 4);
+
+		// Отсортированные на этапе компиляции таблицы
+		constexpr auto merge_sorted = merge_sort::Sorted(array{ 42, -9, 15, 3, -21, 95, 38, 17, -30, 12, 19, 44, 0, 24, 15 });
+		constexpr auto quick_sorted = [] {
+			array values{ 42, -9, 15, 3, -21, 95, 38, 17, -30, 12, 19, 44, 0, 24, 15 };
+			in_place_quick_sort::ConstexprQuickSort(values.begin(), values.end());
+			return values;
+		}();
+
+		constexpr bool tables_sorted = [&] {
+			for (size_t i = 0; i < merge_sorted.size(); ++i) {
+				if (merge_sorted[i] != quick_sorted[i]) return false;
+				if (i > 0u && merge_sorted[i] < merge_sorted[i - 1u]) return false;
+			}
+			return true;
+		}();
+		static_assert(tables_sorted && merge_sorted.front() == -30 && merge_sorted.back() == 95);
+
+		// Политика ошибок без исключений во время выполнения работает так же, как и по умолчанию
+		StaticRingBufferDeque<int, 2, AbortErrorPolicy> abort_ring;
+		abort_ring.push_back(1);
+		abort_ring.push_front(0);
+		assert(!abort_ring.is_capacity_enough() && abort_ring.pop_front() == 0);
+
+		for (const auto& e : merge_sorted) cout << e << " "s;
+		cout << endl;
+	}
+
+	// Тестирование аппаратных счётчиков производительности (если они недоступны, значения выводятся как "n/a")
+	{
+		using namespace perf_counters;
+
+		cout << endl << "PerfCounters testing"s << endl;
+
+		constexpr size_t OPERATIONS = 1u << 18;
+
+		vector<int> values(OPERATIONS);
+		for (size_t i = 0; i < values.size(); ++i) values[i] = static_cast<int>((i * 2654435761u) % 1000003u);
+		vector<int> copy = values;
+
+		// Счётчики открываются до запуска сортировок, чтобы учесть и потоки std::async
+		PerfCounters counters;
+		cout << "counters available: "s << (counters.any_available() ? "yes"s : "no"s) << endl;
+
+		const PerfCounterValues quick_sort = counters.measure([&] { in_place_quick_sort::InPlaceQuickSort(values.begin(), values.end()); });
+		const PerfCounterValues merge_sort = counters.measure([&] { merge_sort::MergeSort(copy.begin(), copy.end()); });
+		assert(is_sorted(values.begin(), values.end()) && values == copy);
+
+		dynamic_ring_buffer_deque::DynamicRingBufferDeque<int> ring;
+		const PerfCounterValues deque_push = Measure([&] { for (size_t i = 0; i < OPERATIONS; ++i) ring.push_back(static_cast<int>(i)); });
+		assert(ring.size() == OPERATIONS);
+
+		// Значения доступных событий неотрицательны, недоступных - пусты
+		for (size_t i = 0; i < EVENT_COUNT; ++i) {
+			assert(quick_sort.values[i].has_value() == counters.available(static_cast<Event>(i)));
+			assert(!quick_sort.values[i] || *quick_sort.values[i] >= 0.0);
+		}
+
+		cout << "InPlaceQuickSort per element: "s << quick_sort.per(OPERATIONS) << endl;
+		cout << "MergeSort per element:        "s << merge_sort.per(OPERATIONS) << endl;
+		cout << "push_back per element:        "s << deque_push.per(OPERATIONS) << endl;
+	}
+
+	// Тестирование режима перезаписи самого старого элемента и "бортового самописца"
+	{
+		using namespace static_ring_buffer_deque;
+		using namespace flight_recorder;
+
+		cout << endl << "FlightRecorder testing"s << endl;
+
+		// При заполненном буфере push_back_overwrite вытесняет самый старый элемент вместо исключения
+		StaticRingBufferDeque<int, 3> ring;
+		assert(!ring.push_back_overwrite(1));
+		assert(!ring.push_back_overwrite(2));
+		assert(!ring.push_back_overwrite(3));
+		assert(ring.push_back_overwrite(4));
+		assert(ring.size() == 3u && ring[0] == 2 && ring[1] == 3 && ring[2] == 4);
+
+		cout << ring << endl;
+
+		// Один поток пишет возрастающую последовательность, а основной поток снимает снимки:
+		// каждый снимок должен быть непрерывным куском последовательности
+		FlightRecorder<int, 64> recorder;
+		constexpr int writes = 200000;
+
+		thread writer([&recorder] { for (int i = 0; i < writes; ++i) recorder.push_back(i); });
+
+		StaticRingBufferDeque<int, 64> snapshot;
+		while (recorder.total_written() < static_cast<uint64_t>(writes)) {
+			recorder.snapshot(snapshot);
+			for (size_t i = 1; i < snapshot.size(); ++i) assert(snapshot[i] == snapshot[i - 1] + 1);
+		}
+
+		writer.join();
+
+		// После окончания записи снимок содержит ровно последние 64 элемента
+		snapshot = recorder.snapshot();
+		assert(snapshot.size() == 64u && snapshot[0] == writes - 64 && snapshot[63] == writes - 1);
+
+		// Элемент из нескольких машинных слов тоже никогда не попадает в снимок наполовину перезаписанным
+		struct FrameEvent { uint64_t frame; uint64_t check; };
+		FlightRecorder<FrameEvent, 16> events;
+
+		thread events_writer([&events] { for (uint64_t i = 0; i < 100000u; ++i) events.push_back({ i, ~i }); });
+
+		StaticRingBufferDeque<FrameEvent, 16> events_snapshot;
+		while (events.total_written() < 100000u) {
+			events.snapshot(events_snapshot);
+			for (size_t i = 0; i < events_snapshot.size(); ++i) {
+				assert(events_snapshot[i].check == ~events_snapshot[i].frame);
+				assert(i == 0u || events_snapshot[i].frame == events_snapshot[i - 1].frame + 1u);
+			}
+		}
+
+		events_writer.join();
+	}
+
+	// Тестирование дека на кольцевом буфере в отображённом в память файле
+#if defined(__unix__) || defined(__APPLE__)
+	{
+		using namespace mapped_ring_buffer_deque;
+
+		cout << endl << "MappedRingBufferDeque testing"s << endl;
+
+		const string path = (filesystem::temp_directory_path() / "mapped_ring_buffer_deque_test.bin"s).string();
+		remove(path.c_str());
+
+		{
+			MappedRingBufferDeque<int> ring(path, 2u);
+			assert(ring.empty());
+
+			// Добавляем элементы так, чтобы диапазон "перескочил" через конец буфера и буфер расширялся
+			ring.push_back(3);
+			ring.push_front(2);
+			ring.push_back(4);
+			ring.push_front(1);
+			ring.push_back(5);
+
+			assert(ring.size() == 5u && ring.capacity() == 8u);
+			assert(ring[0] == 1 && ring[1] == 2 && ring[2] == 3 && ring[3] == 4 && ring[4] == 5);
+
+			ring.checkpoint();
+		}
+
+		// После повторного открытия содержимое доступно без десериализации
+		{
+			MappedRingBufferDeque<int> ring(path);
+			assert(ring.size() == 5u && ring.capacity() == 8u);
+			assert(ring[0] == 1 && ring[1] == 2 && ring[2] == 3 && ring[3] == 4 && ring[4] == 5);
+
+			cout << ring << endl;
+
+			assert(ring.pop_front() == 1 && ring.pop_back() == 5);
+		}
+
+		// Файл с другим типом элементов открыть нельзя
+		try { MappedRingBufferDeque<double> ring(path); assert(false); }
+		catch (const runtime_error&) { }
+		catch (...) { assert(false); }
+
+		assert(MappedRingBufferDeque<int>(path).size() == 3u);
+
+		remove(path.c_str());
+
+		// После каждого изменения раскладки (расширения буфера с переносом "перескочившей" части диапазона,
+		// в том числе при приросте ёмкости меньше переносимой части) файл открывается заново и сверяется с эталоном
+		{
+			deque<int> expected;
+			size_t layout_changes = 0u;
+
+			for (int i = 0; i < 200; ++i) {
+				size_t capacity = 0u;
+				{
+					MappedRingBufferDeque<int> ring(path, 3u);
+					capacity = ring.capacity();
+
+					if      (i % 3 == 0) { ring.push_front(i); expected.push_front(i); }
+					else if (i % 7 == 0) { assert(ring.pop_back() == expected.back()); expected.pop_back(); }
+					else                 { ring.push_back(i); expected.push_back(i); }
+
+					if (i % 50 == 49) ring.reserve(ring.capacity() + 1u);
+					if (ring.capacity() == capacity) continue;
+
+					++layout_changes;
+				}
+
+				MappedRingBufferDeque<int> ring(path);
+				assert(ring.capacity() > capacity && ring.size() == expected.size());
+				for (size_t index = 0; index < expected.size(); ++index) assert(ring[index] == expected[index]);
+			}
+
+			assert(layout_changes >= 7u);
+			remove(path.c_str());
+		}
+
+		// После каждого push_front/pop_front (смещение начала вместе с изменением размера) файл открывается заново
+		{
+			deque<int> expected;
+
+			for (int i = 0; i < 40; ++i) {
+				{
+					MappedRingBufferDeque<int> ring(path, 8u);
+					if (i % 4 == 3) { assert(ring.pop_front() == expected.front()); expected.pop_front(); }
+					else            { ring.push_front(i); expected.push_front(i); }
+				}
+
+				MappedRingBufferDeque<int> ring(path);
+				assert(ring.size() == expected.size());
+				for (size_t index = 0; index < expected.size(); ++index) assert(ring[index] == expected[index]);
+			}
+
+			// Сбой между записью новой раскладки и её публикацией: в свободной ячейке заголовка лежит
+			// недописанная раскладка, но файл открывается с последней опубликованной
+			{
+				mapped_ring_buffer_deque::MappedHeader header {};
+				fstream file(path, ios::in | ios::out | ios::binary);
+				file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+				header.layouts[(header.generation + 1u) % 2u] = { header.layouts[header.generation % 2u].capacity, 12345u, 0u };
+				file.seekp(0);
+				file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			}
+
+			MappedRingBufferDeque<int> ring(path);
+			assert(ring.size() == expected.size());
+			for (size_t index = 0; index < expected.size(); ++index) assert(ring[index] == expected[index]);
+		}
+		remove(path.c_str());
+
+		// Перемещённый объект не владеет файлом
+		{
+			MappedRingBufferDeque<int> ring(path, 2u);
+			ring.push_back(1);
+
+			MappedRingBufferDeque<int> moved(move(ring));
+			assert(ring.empty() && ring.size() == 0u && ring.capacity() == 0u && moved.size() == 1u);
+			ring.clear();
+
+			try { ring.push_back(2); assert(false); }
+			catch (const logic_error&) { }
+			catch (...) { assert(false); }
+
+			ring = move(moved);
+			assert(ring.size() == 1u && ring[0] == 1);
+		}
+
+		remove(path.c_str());
+	}
+#endif
+
+	// Тестирование многоключевой быстрой сортировки строк
+	{
+		using namespace string_sort;
+
+		cout << endl << "StringSort testing"s << endl;
+
+		vector<string> names({ "assets/textures/tank_t34_hull.dds"s, "assets/textures/tank_is7_hull.dds"s, "assets/models/tank_t34.obj"s,
+		                       "assets/textures/tank_t34_turret.dds"s, "assets/"s, "assets/textures/tank_is7_hull.dds"s, "Assets/readme.txt"s,
+		                       "assets/models/tank_is7.obj"s, ""s, "assets/textures/tank_t34_hull.dd"s, "assets/sounds/shot.wav"s });
+
+		for (int i = 0; i < 40; ++i) names.push_back("assets/textures/generated_"s + to_string((i * 37) % 40) + ".dds"s);
+
+		vector<string> expected(names);
+		sort(expected.begin(), expected.end());
+
+		// Сортировка массива std::string_view не копирует сами строки
+		vector<string_view> views(names.begin(), names.end());
+		StringSort(views.begin(), views.end());
+		assert(equal(views.begin(), views.end(), expected.begin(), expected.end()));
+
+		// Сортировка массива std::string обменивает строки без копирования содержимого
+		StringSort(names.begin(), names.end());
+		assert(names == expected);
+
+		for (size_t i = 0; i < 11; ++i) cout << "\""s << names[i] << "\" "s;
+		cout << endl;
+	}
+
+	// Тестирование возобновляемой сортировки с ограничением объёма работы на шаг
+	{
+		using namespace resumable_sort;
+
+		cout << endl << "ResumableMergeSort testing"s << endl;
+
+		vector<int> values({ 42, -9, 15, 3, -21, 95, 38, 17, -30, 12, 19, 44, 0, 24, 15, 68, 21, -49, -51 });
+		vector<int> expected(values);
+		sort(expected.begin(), expected.end());
+
+		// Сортируем по 10 единиц работы за "кадр", прогресс должен монотонно расти
+		ResumableMergeSort<vector<int>::iterator> sorter(values.begin(), values.end());
+		int frames = 0;
+		double progress = 0.0;
+
+		while (!sorter.step(10u)) {
+			assert(sorter.progress() >= progress && sorter.progress() < 1.0);
+			progress = sorter.progress();
+			++frames;
+		}
+
+		assert(sorter.progress() == 1.0);
+		assert(values == expected);
+
+		cout << "frames: "s << frames + 1 << endl;
+		for (const auto& e : values) cout << e << " "s;
+		cout << endl;
+
+		// Сортировка большого массива с ограничением времени на "кадр"
+		vector<int> big(100000);
+		for (size_t i = 0; i < big.size(); ++i) big[i] = static_cast<int>((i * 7919u) % 100003u);
+
+		ResumableMergeSort<vector<int>::iterator> big_sorter(big.begin(), big.end());
+		while (!big_sorter.step(chrono::microseconds(500))) { }
+
+		assert(is_sorted(big.begin(), big.end()));
+	}
+
+	// Тестирование асинхронной сортировки для корутин (доступна при сборке со стандартом C++20)
+#if defined(__cpp_impl_coroutine) && defined(__cpp_lib_jthread)
+	{
+		cout << endl << "AsyncSort testing"s << endl;
+
+		vector<int> values(100000);
+		for (size_t i = 0; i < values.size(); ++i) values[i] = static_cast<int>((i * 7919u) % 100003u);
+
+		// Корутина приостанавливается на co_await, а основной поток свободен, пока сортировка идёт на исполнителе
+		promise<bool> done;
+		future<bool> done_future = done.get_future();
+		SortValuesAsync(values, done, stop_token());
+
+		assert(done_future.get());
+		assert(is_sorted(values.begin(), values.end()));
+
+		// Отменённая сортировка завершает co_await с результатом false
+		stop_source stop;
+		stop.request_stop();
+
+		vector<int> cancelled_values(100000, 1);
+		promise<bool> cancelled;
+		future<bool> cancelled_future = cancelled.get_future();
+		SortValuesAsync(cancelled_values, cancelled, stop.get_token());
+
+		assert(!cancelled_future.get());
+
+		// Исключение компаратора в любой из задач возобновляет корутину и выбрасывается из co_await
+		vector<int> throwing_values(values.rbegin(), values.rend());
+		promise<bool> failed;
+		future<bool> failed_future = failed.get_future();
+		SortValuesThrowingAsync(throwing_values, failed, values[values.size() / 2u]);
+
+		try { failed_future.get(); assert(false); }
+		catch (const runtime_error& e) { assert(e.what() == "comparator failure"s); }
+		catch (...) { assert(false); }
+
+		cout << "sorted: "s << values.front() << " ... "s << values.back() << endl;
+	}
+#endif
+
 	return 0;
 }
\ No newline at end of file
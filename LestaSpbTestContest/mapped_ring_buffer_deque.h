@@ -0,0 +1,349 @@
+#pragma once
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <cerrno>
+#include <atomic>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+// Отображение файла в память реализовано через POSIX (mmap/msync), на других платформах класс недоступен
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace mapped_ring_buffer_deque {
+
+// Раскладка данных в кольцевом буфере
+struct MappedLayout {
+    uint64_t capacity;   // Ёмкость кольцевого буфера
+    uint64_t head_index; // Индекс начала диапазона данных в буфере
+    uint64_t size;       // Размер диапазона, занятого данными в буфере
+};
+
+// Заголовок файла дека (данные кольцевого буфера идут сразу после него)
+//
+// Раскладок в заголовке две: действующая - layouts[generation % 2]. Новая раскладка записывается в другую
+// ячейку, после чего публикуется одной записью поколения (выровненное 64-битное слово), так что файл всегда
+// описывает либо старую, либо новую раскладку целиком
+struct alignas(64) MappedHeader {
+    uint64_t     magic;        // Сигнатура формата
+    uint32_t     version;      // Версия формата
+    uint32_t     element_size; // Размер элемента (защита от открытия файла с другим типом элементов)
+    uint64_t     generation;   // Поколение (номер последней опубликованной раскладки)
+    MappedLayout layouts[2];   // Действующая и следующая раскладки
+};
+
+constexpr uint64_t MAPPED_MAGIC   = 0x52494E4752425144ull; // "RINGRBQD"
+constexpr uint32_t MAPPED_VERSION = 2u;
+
+// Класс дека на кольцевом буфере, который хранится в отображённом в память файле: после перезапуска процесса
+// содержимое доступно сразу после открытия файла, без десериализации (поэтому тип элементов должен быть
+// тривиально копируемым). Данные попадают в файл средствами ОС, а функция checkpoint() позволяет дождаться их
+// записи на диск, ограничивая потери при сбое
+//
+// Порядок записи выбран так, чтобы файл всегда оставался согласованным: сначала записываются данные
+// (элемент, а при расширении - копия данных в новом, не занятом элементами месте, подробнее - в reserve()),
+// затем новая раскладка в свободную ячейку заголовка, и только после этого она публикуется сменой поколения
+// с семантикой release (компилятор и процессор не переносят предшествующие записи за неё). Поэтому сбой
+// процесса в любой момент оставляет файл, который открывается с последней опубликованной раскладкой
+//
+// После перемещения исходный объект не владеет файлом: он пуст, его ёмкость равна нулю, а добавление
+// элементов и остальные операции с файлом выбрасывают исключение std::logic_error
+template <typename Type>
+class MappedRingBufferDeque {
+private:
+    static_assert(std::is_trivially_copyable_v<Type>, "mapped-ring-buffer-deque element type must be trivially copyable");
+    static_assert(alignof(Type) <= alignof(MappedHeader), "mapped-ring-buffer-deque element type is over-aligned");
+
+    int           file_       = -1;      // Дескриптор файла
+    void*         mapping_    = nullptr; // Адрес отображения файла в память
+    size_t        mapped_len_ = 0u;      // Длина отображения
+    MappedHeader* header_     = nullptr; // Заголовок в отображении
+    Type*         buff_       = nullptr; // Буфер данных в отображении
+    uint64_t      generation_ = 0u;      // Поколение действующей раскладки
+    MappedLayout  layout_     = {};      // Копия действующей раскладки (файлом владеет только этот объект)
+
+    // Функция получения размера файла для заданной ёмкости
+    static size_t file_length(size_t capacity) { return sizeof(MappedHeader) + capacity * sizeof(Type); }
+
+    // Функция выбрасывания исключения с кодом последней ошибки системного вызова
+    [[noreturn]] static void throw_system_error(const std::string& what) {
+        throw std::system_error(errno, std::generic_category(), "mapped-ring-buffer-deque " + what);
+    }
+
+    // Функция отображения файла длины length в память
+    void map(size_t length) {
+        void* mapping = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, file_, 0);
+        if (mapping == MAP_FAILED) throw_system_error("mmap() failed");
+
+        mapping_    = mapping;
+        mapped_len_ = length;
+        header_     = static_cast<MappedHeader*>(mapping);
+        buff_       = reinterpret_cast<Type*>(static_cast<char*>(mapping) + sizeof(MappedHeader));
+    }
+
+    // Функция снятия отображения и закрытия файла
+    void unmap_and_close() noexcept {
+        if (mapping_) munmap(mapping_, mapped_len_);
+        if (file_ >= 0) close(file_);
+
+        file_ = -1; mapping_ = nullptr; mapped_len_ = 0u; header_ = nullptr; buff_ = nullptr;
+    }
+
+    // Функция проверки, что объект владеет файлом (не был перемещён)
+    void check_mapped(const char* operation) const {
+        using namespace std;
+
+        // В случае перемещённого объекта выбразываем исключение
+        if (!header_) throw logic_error(operation + " call for moved-from mapped-ring-buffer-deque"s);
+    }
+
+    // Функция записи слова с семантикой release (при отсутствии std::atomic_ref - с барьером компилятора,
+    // которого достаточно для сбоя процесса: все выполненные процессом записи остаются в страничном кэше ОС)
+    static void store_release(uint64_t& word, uint64_t value) noexcept {
+#if defined(__cpp_lib_atomic_ref)
+        std::atomic_ref<uint64_t>(word).store(value, std::memory_order_release);
+#else
+        std::atomic_signal_fence(std::memory_order_release);
+        *static_cast<volatile uint64_t*>(&word) = value;
+#endif
+    }
+
+    // Функция публикации новой раскладки: запись в свободную ячейку, затем смена поколения
+    void publish(const MappedLayout& layout) noexcept {
+        const uint64_t generation = generation_ + 1u;
+
+        header_->layouts[generation % 2u] = layout;
+        store_release(header_->generation, generation);
+
+        generation_ = generation;
+        layout_     = layout;
+    }
+
+    // Функция резервирования места под новые элементы, если его недостаточно (аналогично динамическому деку)
+    void reserve_if_not_enough() {
+        if (layout_.size == layout_.capacity) reserve(layout_.capacity ? layout_.capacity * 2u : 1u);
+    }
+
+public:
+    // Конструктор: открывает файл path, если он существует (содержимое сразу доступно), или создаёт новый с ёмкостью capacity
+    explicit MappedRingBufferDeque(const std::string& path, size_t capacity = 1024u) {
+        using namespace std;
+
+        file_ = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (file_ < 0) throw_system_error("open() failed for "s + path);
+
+        try {
+            struct stat file_stat {};
+            if (fstat(file_, &file_stat) != 0) throw_system_error("fstat() failed"s);
+
+            // Новый файл: задаём размер и записываем заголовок
+            if (file_stat.st_size == 0) {
+                if (capacity == 0u) capacity = 1u;
+                if (ftruncate(file_, static_cast<off_t>(file_length(capacity))) != 0) throw_system_error("ftruncate() failed"s);
+
+                map(file_length(capacity));
+                *header_ = MappedHeader{ MAPPED_MAGIC, MAPPED_VERSION, static_cast<uint32_t>(sizeof(Type)), 0u, { { capacity, 0u, 0u }, {} } };
+                layout_  = header_->layouts[0];
+            }
+            // Существующий файл: проверяем заголовок и размер
+            else {
+                if (static_cast<size_t>(file_stat.st_size) < sizeof(MappedHeader)) throw runtime_error("mapped-ring-buffer-deque file is too small: "s + path);
+
+                map(static_cast<size_t>(file_stat.st_size));
+
+                if (header_->magic        != MAPPED_MAGIC)   throw runtime_error("mapped-ring-buffer-deque file has wrong signature: "s + path);
+                if (header_->version      != MAPPED_VERSION) throw runtime_error("mapped-ring-buffer-deque file has unsupported version: "s + path);
+                if (header_->element_size != sizeof(Type))   throw runtime_error("mapped-ring-buffer-deque file has wrong element size: "s + path);
+
+                generation_ = header_->generation;
+                layout_     = header_->layouts[generation_ % 2u];
+
+                if (layout_.capacity == 0u || file_length(layout_.capacity) > mapped_len_ ||
+                    layout_.size > layout_.capacity || layout_.head_index >= layout_.capacity) {
+                    throw runtime_error("mapped-ring-buffer-deque file is corrupted: "s + path);
+                }
+            }
+        }
+        catch (...) {
+            unmap_and_close();
+            throw;
+        }
+    }
+
+    // Копирование запрещено (два объекта не должны владеть одним отображением)
+    MappedRingBufferDeque(const MappedRingBufferDeque&) = delete;
+    MappedRingBufferDeque& operator = (const MappedRingBufferDeque&) = delete;
+
+    // Конструктор перемещения (исходный объект остаётся без файла)
+    MappedRingBufferDeque(MappedRingBufferDeque&& rvalue) noexcept { swap(rvalue); }
+
+    // Оператор присвоения с перемещением (прежний файл этого объекта переходит к rvalue и закрывается вместе с ним)
+    MappedRingBufferDeque& operator = (MappedRingBufferDeque&& rvalue) noexcept { swap(rvalue); return *this; }
+
+    // Деструктор: снимает отображение (данные в файле сохраняются, ОС запишет их на диск)
+    ~MappedRingBufferDeque() { unmap_and_close(); }
+
+    // Функция обмена с другим деком
+    void swap(MappedRingBufferDeque& other) noexcept {
+        std::swap(file_, other.file_);
+        std::swap(mapping_, other.mapping_);
+        std::swap(mapped_len_, other.mapped_len_);
+        std::swap(header_, other.header_);
+        std::swap(buff_, other.buff_);
+        std::swap(generation_, other.generation_);
+        std::swap(layout_, other.layout_);
+    }
+
+    // Функция сохранения контрольной точки: дожидается записи данных на диск (при async = true только
+    // инициирует запись). Всё, что было записано до вызова, переживёт сбой процесса и ОС
+    void checkpoint(bool async = false) {
+        check_mapped("checkpoint()");
+        if (msync(mapping_, mapped_len_, async ? MS_ASYNC : MS_SYNC) != 0) throw_system_error("msync() failed");
+    }
+
+    // Функция резервирования места (ёмкость может получиться больше запрошенной, см. ниже)
+    //
+    // Данные, "перескакивающие" через конец буфера, копируются сразу за старый конец - в место, которое не
+    // занято ни одним элементом ни в старой, ни в новой раскладке (индекс начала не меняется), так что файл,
+    // прочитанный после сбоя в любой момент, описывает либо старую, либо новую раскладку:
+    //   1. файл увеличивается (лишнее место в конце файла допустимо при открытии);
+    //   2. новое отображение создаётся до снятия старого (при ошибке дек остаётся в прежнем состоянии);
+    //   3. начало диапазона из начала буфера копируется в [capacity; capacity + wrapped);
+    //   4. публикуется раскладка с новой ёмкостью
+    void reserve(size_t new_capacity) {
+        check_mapped("reserve()");
+
+        const size_t capacity = layout_.capacity;
+
+        // Если новая ёмкость не больше предыдущей, ничего не делаем
+        if (new_capacity <= capacity) return;
+
+        // Для переноса нужно хотя бы wrapped новых мест, поэтому при очень маленьком приросте ёмкость
+        // увеличивается сильнее (не больше, чем вдвое)
+        const size_t tail_end = layout_.head_index + layout_.size;
+        const size_t wrapped  = tail_end > capacity ? tail_end - capacity : 0u;
+        if (new_capacity < capacity + wrapped) new_capacity = capacity + wrapped;
+
+        // Сначала увеличиваем файл и отображаем его заново, старое отображение снимаем только после успеха
+        if (ftruncate(file_, static_cast<off_t>(file_length(new_capacity))) != 0) throw_system_error("ftruncate() failed");
+
+        void* const  old_mapping    = mapping_;
+        const size_t old_mapped_len = mapped_len_;
+        map(file_length(new_capacity));
+        munmap(old_mapping, old_mapped_len);
+
+        // Копируем часть диапазона из начала буфера сразу за старый конец (старые копии остаются на месте
+        // и перестают быть частью диапазона только после публикации раскладки)
+        if (wrapped > 0u) std::memcpy(buff_ + capacity, buff_, wrapped * sizeof(Type));
+
+        // Только теперь публикуем новую раскладку
+        publish({ new_capacity, layout_.head_index, layout_.size });
+    }
+
+    // Функция очистки дека
+    void clear() { if (header_) publish({ layout_.capacity, 0u, 0u }); }
+
+    // Функция получения размера
+    size_t size() const { return static_cast<size_t>(layout_.size); }
+
+    // Функция получения ёмкости
+    size_t capacity() const { return static_cast<size_t>(layout_.capacity); }
+
+    // Функция проверки на пустоту
+    bool empty() const { return layout_.size == 0u; }
+
+    // Функция добавления в конец
+    void push_back(const Type& value) {
+        check_mapped("push_back()");
+        reserve_if_not_enough();
+
+        buff_[(layout_.head_index + layout_.size) % layout_.capacity] = value; // Сначала записываем значение в конец диапазона
+        publish({ layout_.capacity, layout_.head_index, layout_.size + 1u });  // Затем публикуем увеличенный размер
+    }
+
+    // Функция добавления в начало
+    void push_front(const Type& value) {
+        check_mapped("push_front()");
+        reserve_if_not_enough();
+
+        const size_t new_head = (layout_.head_index + layout_.capacity - 1u) % layout_.capacity;
+        buff_[new_head] = value;                                    // Сначала записываем значение перед началом диапазона
+        publish({ layout_.capacity, new_head, layout_.size + 1u }); // Затем публикуем смещённое начало вместе с размером
+    }
+
+    // Функция удаления из конца
+    Type pop_back() {
+        using namespace std;
+
+        // В случае пустого дека выбразываем исключение
+        if (empty()) throw out_of_range("pop_back() call from empty mapped-ring-buffer-deque"s);
+
+        Type value = buff_[(layout_.head_index + layout_.size - 1u) % layout_.capacity];
+        publish({ layout_.capacity, layout_.head_index, layout_.size - 1u });
+
+        return value;
+    }
+
+    // Функция удаления из начала
+    Type pop_front() {
+        using namespace std;
+
+        // В случае пустого дека выбразываем исключение
+        if (empty()) throw out_of_range("pop_front() call from empty mapped-ring-buffer-deque"s);
+
+        Type value = buff_[layout_.head_index];
+        publish({ layout_.capacity, (layout_.head_index + 1u) % layout_.capacity, layout_.size - 1u });
+
+        return value;
+    }
+
+    // Функция получения ссылки на элемент с определённым индексом
+    Type& operator [] (size_t index) {
+        using namespace std;
+
+        // В случае попытки получения ссылки на элемент с индексом за границей диапазона значений дека, выбразываем исключение
+        if (index >= size()) throw out_of_range("operator [] call for out of range index"s);
+
+        return buff_[(layout_.head_index + index) % layout_.capacity];
+    }
+
+    // Функция получения константной ссылки на элемент с определённым индексом
+    const Type& operator [] (size_t index) const {
+        using namespace std;
+
+        // В случае попытки получения ссылки на элемент с индексом за границей диапазона значений дека, выбразываем исключение
+        if (index >= size()) throw out_of_range("operator [] call for out of range index"s);
+
+        return buff_[(layout_.head_index + index) % layout_.capacity];
+    }
+};
+
+// Перегрузка оператора "<<" для вывода элементов дека в поток
+template <typename Type>
+std::ostream& operator << (std::ostream& os, const MappedRingBufferDeque<Type>& mapped_deque) {
+    using namespace std;
+
+    os << "["s;
+    bool first = true;
+
+    for (size_t index = 0; index < mapped_deque.size(); ++index) {
+        if (first) first = false;
+        else       os << ", "s;
+        os << mapped_deque[index];
+    }
+
+    os << "]"s;
+
+    return os;
+}
+
+}
+
+#endif
\ No newline at end of file
@@ -1,9 +1,12 @@
 #pragma once
 #include <algorithm>
 #include <numeric>
+#include <functional>
+#include <array>
 #include <vector>
 #include <future>
 #include <cmath>
+#include "instrumentation.h"
 
 namespace merge_sort {
 
@@ -19,8 +22,13 @@ void MergeSort(RandomIt begin, RandomIt end, int max_async_depth, int depth) {
     // Если диапазон содержит меньше 2 элементов, выходим из функции
     if (range_length < 2) return;
 
+    // Замер времени на текущем уровне рекурсии (при включённом инструментировании)
+    INSTRUMENTATION_LEVEL_TIMER(depth);
+
     // Создаём вектор, содержащий все элементы текущего диапазона
     vector<typename iterator_traits<RandomIt>::value_type> elements(begin, end);
+    INSTRUMENTATION_ADD(HEAP_ALLOCATIONS, 1);
+    INSTRUMENTATION_ADD(ELEMENT_MOVES, range_length);
 
     // Разбиваем вектор на две равные части
     auto mid = elements.begin() + range_length / 2;
@@ -32,6 +40,7 @@ void MergeSort(RandomIt begin, RandomIt end, int max_async_depth, int depth) {
     // Если текущий уровень рекурсии меньше, чем максимальный - запускаем задачи по
     // сортировки половинок параллельно с помощью std::async
     if (depth <= max_async_depth) {
+        INSTRUMENTATION_ADD(ASYNC_TASKS, 1);
         auto left_future = async(left_task);
         right_task();
         left_future.get();
@@ -43,7 +52,9 @@ void MergeSort(RandomIt begin, RandomIt end, int max_async_depth, int depth) {
     }
 
     // С помощью merge сливаем отсортированные половины в исходный диапазон
-    merge(elements.begin(), mid, mid, elements.end(), begin);
+    // (при включённом инструментировании компаратор считает сравнения)
+    merge(elements.begin(), mid, mid, elements.end(), begin, instrumentation::CountComparisons(less<>()));
+    INSTRUMENTATION_ADD(ELEMENT_MOVES, range_length);
 
     // Также можно подключить <execution> и запустить merge с параллельными политиками, доступными с C++17:
     // merge(execution::par, elements.begin(), mid, mid, elements.end(), begin);
@@ -61,4 +72,166 @@ void MergeSort(RandomIt begin, RandomIt end) {
     MergeSort(begin, end, max_async_depth, 0);
 }
 
-}
\ No newline at end of file
+
+// Функция стабильного слияния отсортированных полуинтервалов [begin; mid) и [mid; end) на месте с буфером scratch
+// ограниченного размера scratch_size. Если меньшая из половинок помещается в буфер, слияние линейное, а иначе
+// половинки делятся бинарным поиском, средние части меняются местами поворотом (std::rotate) и получившиеся
+// меньшие слияния выполняются рекурсивно (при пустом буфере - O(N log N) на слияние без дополнительной памяти)
+template <typename RandomIt, typename ScratchIt>
+void MergeWithScratch(RandomIt begin, RandomIt mid, RandomIt end, ScratchIt scratch, size_t scratch_size) {
+    using namespace std;
+
+    const size_t left_length  = static_cast<size_t>(distance(begin, mid));
+    const size_t right_length = static_cast<size_t>(distance(mid, end));
+
+    // Если одна из половинок пуста или они уже упорядочены друг относительно друга, сливать нечего
+    if (left_length == 0u || right_length == 0u || !(*mid < *prev(mid))) return;
+
+    // Левая половинка помещается в буфер: переносим её туда и сливаем слева направо
+    if (left_length <= scratch_size) {
+        ScratchIt scratch_end = move(begin, mid, scratch);
+        merge(make_move_iterator(scratch), make_move_iterator(scratch_end), make_move_iterator(mid), make_move_iterator(end), begin);
+        return;
+    }
+
+    // Правая половинка помещается в буфер: переносим её туда, сдвигаем левую половинку в конец и сливаем слева направо
+    if (right_length <= scratch_size) {
+        ScratchIt scratch_end = move(mid, end, scratch);
+        move_backward(begin, mid, end); // Освобождаем место: теперь левая половинка занимает [end - left_length; end)
+
+        // Сливаем с начала, выбирая меньший элемент (при равенстве - из левой половинки, для стабильности).
+        // Запись не обгоняет чтение левой половинки, так как впереди неё остаётся место под ещё не слитую правую
+        RandomIt  left  = end - static_cast<ptrdiff_t>(left_length);
+        RandomIt  write = begin;
+        ScratchIt right = scratch;
+        while (left != end && right != scratch_end) {
+            if (*right < *left) *(write++) = move(*(right++));
+            else                *(write++) = move(*(left++));
+        }
+        move(right, scratch_end, write);
+        return;
+    }
+
+    // Ни одна половинка не помещается в буфер: делим большую из них пополам, а меньшую - бинарным поиском
+    RandomIt left_cut, right_cut;
+    if (left_length >= right_length) {
+        left_cut  = begin + static_cast<ptrdiff_t>(left_length / 2u);
+        right_cut = lower_bound(mid, end, *left_cut);
+    }
+    else {
+        right_cut = mid + static_cast<ptrdiff_t>(right_length / 2u);
+        left_cut  = upper_bound(begin, mid, *right_cut);
+    }
+
+    // Меняем местами [left_cut; mid) и [mid; right_cut), после чего сливаем две независимые части
+    RandomIt new_mid = rotate(left_cut, mid, right_cut);
+    INSTRUMENTATION_ADD(ELEMENT_MOVES, distance(left_cut, right_cut));
+
+    MergeWithScratch(begin, left_cut, new_mid, scratch, scratch_size);
+    MergeWithScratch(new_mid, right_cut, end, scratch, scratch_size);
+}
+
+// Параллельная функция стабильной сортировки слиянием на месте для диапазона [begin; end) с буфером ограниченного
+// размера scratch_size. Как и в MergeSort, половинки сортируются параллельно до глубины max_async_depth, но вместо
+// копирования каждого уровня в новый вектор все слияния выполняются на месте через MergeWithScratch. Одновременно
+// работающие задачи делят буфер между собой, так что суммарная дополнительная память не превышает scratch_size
+template <typename RandomIt, typename ScratchIt>
+void MergeSortInPlace(RandomIt begin, RandomIt end, ScratchIt scratch, size_t scratch_size, int max_async_depth, int depth) {
+    using namespace std;
+
+    // Расстояние между итераторами
+    const size_t range_length = static_cast<size_t>(distance(begin, end));
+
+    // Если диапазон содержит меньше 2 элементов, выходим из функции
+    if (range_length < 2u) return;
+
+    // Небольшие диапазоны досортировываем вставками (стабильно и без дополнительной памяти)
+    if (range_length <= 16u) {
+        for (RandomIt current = next(begin); current != end; ++current) {
+            for (RandomIt it = current; it != begin && *it < *prev(it); --it) iter_swap(it, prev(it));
+        }
+        return;
+    }
+
+    // Замер времени на текущем уровне рекурсии (при включённом инструментировании)
+    INSTRUMENTATION_LEVEL_TIMER(depth);
+
+    // Разбиваем диапазон на две равные части
+    RandomIt mid = begin + static_cast<ptrdiff_t>(range_length / 2u);
+
+    // Если текущий уровень рекурсии меньше, чем максимальный - запускаем задачи по сортировке половинок
+    // параллельно с помощью std::async, отдавая каждой свою половину буфера
+    if (depth <= max_async_depth) {
+        const size_t left_scratch_size = scratch_size / 2u;
+        ScratchIt    right_scratch     = scratch + static_cast<ptrdiff_t>(left_scratch_size);
+
+        INSTRUMENTATION_ADD(ASYNC_TASKS, 1);
+        auto left_future = async([=] { MergeSortInPlace(begin, mid, scratch, left_scratch_size, max_async_depth, depth + 1); });
+        MergeSortInPlace(mid, end, right_scratch, scratch_size - left_scratch_size, max_async_depth, depth + 1);
+        left_future.get();
+    }
+    // А иначе выполним их последовательно с целым буфером
+    else {
+        MergeSortInPlace(begin, mid, scratch, scratch_size, max_async_depth, depth + 1);
+        MergeSortInPlace(mid, end,   scratch, scratch_size, max_async_depth, depth + 1);
+    }
+
+    // Сливаем отсортированные половины на месте (к этому моменту обе задачи закончены и весь буфер свободен)
+    MergeWithScratch(begin, mid, end, scratch, scratch_size);
+}
+
+// Параллельная функция стабильной сортировки слиянием на месте для диапазона [begin; end) с дополнительной памятью
+// не более scratch_size элементов (0 - без дополнительной памяти, порядка sqrt(N) - хороший компромисс,
+// N / 2 и больше - линейные слияния): чем больше буфер, тем быстрее сортировка
+template <typename RandomIt>
+void MergeSortInPlace(RandomIt begin, RandomIt end, size_t scratch_size) {
+    using namespace std;
+
+    const size_t range_length = static_cast<size_t>(distance(begin, end));
+
+    // Буфер больше половины диапазона не нужен: в него переносится только меньшая из сливаемых половинок
+    vector<typename iterator_traits<RandomIt>::value_type> scratch(min(scratch_size, range_length / 2u));
+    if (!scratch.empty()) INSTRUMENTATION_ADD(HEAP_ALLOCATIONS, 1);
+
+    // Установим максимальную глубену рекурсии как O(log N)
+    const int max_async_depth = static_cast<int>(log(static_cast<double>(range_length)));
+
+    MergeSortInPlace(begin, end, scratch.begin(), scratch.size(), max_async_depth, 0);
+}
+
+// Функция последовательной сортировки слиянием для вычислений на этапе компиляции (constexpr): без потоков,
+// инструментирования и динамической памяти - вместо неё используется буфер buffer размером не меньше половины
+// диапазона (сортировка стабильная)
+template <typename RandomIt, typename BufferIt, typename Comparator = std::less<>>
+constexpr void ConstexprMergeSort(RandomIt begin, RandomIt end, BufferIt buffer, Comparator comparator = Comparator()) {
+    const auto range_length = end - begin;
+    if (range_length < 2) return;
+
+    const RandomIt mid = begin + range_length / 2;
+    ConstexprMergeSort(begin, mid, buffer, comparator);
+    ConstexprMergeSort(mid,   end, buffer, comparator);
+
+    // Переносим левую половинку в буфер
+    BufferIt left = buffer, left_end = buffer;
+    for (RandomIt it = begin; it != mid; ++it, ++left_end) *left_end = std::move(*it);
+
+    // Сливаем слева направо (при равенстве - из левой половинки, для стабильности), запись никогда не обгоняет
+    // чтение правой половинки, а её оставшиеся элементы уже стоят на своих местах
+    RandomIt right = mid, write = begin;
+    while (left != left_end) {
+        if (right != end && comparator(*right, *left)) *(write++) = std::move(*(right++));
+        else                                           *(write++) = std::move(*(left++));
+    }
+}
+
+// Функция получения отсортированной копии массива, пригодная для вычислений на этапе компиляции, например,
+// для таблиц, которые должны лежать в .rodata без инициализации при запуске:
+// constexpr auto table = merge_sort::Sorted(std::array{ 3, 1, 2 });
+template <typename Type, size_t size, typename Comparator = std::less<>>
+constexpr std::array<Type, size> Sorted(std::array<Type, size> values, Comparator comparator = Comparator()) {
+    std::array<Type, size / 2u + 1u> buffer = {};
+    ConstexprMergeSort(values.begin(), values.end(), buffer.begin(), comparator);
+    return values;
+}
+
+}
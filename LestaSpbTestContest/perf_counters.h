@@ -0,0 +1,203 @@
+#pragma once
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <array>
+#include <optional>
+#include <utility>
+#include <cstdint>
+
+// Аппаратные счётчики производительности доступны через perf_event_open только в Linux,
+// на других платформах все счётчики считаются недоступными
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+namespace perf_counters {
+
+// Измеряемые события
+enum class Event {
+    CYCLES,        // Такты процессора
+    INSTRUCTIONS,  // Выполненные инструкции
+    BRANCH_MISSES, // Неверно предсказанные переходы
+    L1D_MISSES,    // Промахи чтения кэша данных L1
+    LLC_MISSES,    // Промахи чтения кэша последнего уровня
+    DTLB_MISSES,   // Промахи чтения TLB данных
+    COUNT
+};
+
+constexpr size_t EVENT_COUNT = static_cast<size_t>(Event::COUNT);
+
+// Имена событий для вывода
+constexpr std::array<const char*, EVENT_COUNT> EVENT_NAMES = { "cycles", "instructions", "branch_misses", "l1d_misses", "llc_misses", "dtlb_misses" };
+
+// Значения счётчиков (пустые для недоступных событий)
+struct PerfCounterValues {
+    std::array<std::optional<double>, EVENT_COUNT> values = {};
+
+    const std::optional<double>& operator [] (Event event) const { return values[static_cast<size_t>(event)]; }
+    std::optional<double>&       operator [] (Event event)       { return values[static_cast<size_t>(event)]; }
+
+    // Функция пересчёта значений на единицу работы (например, на один вызов сортировки
+    // или, при operations = 10^6, на миллион операций с деком нужно передать units = operations / 10^6)
+    PerfCounterValues per(double units) const {
+        PerfCounterValues result;
+        for (size_t i = 0; i < EVENT_COUNT; ++i) {
+            if (values[i] && units > 0.0) result.values[i] = *values[i] / units;
+        }
+        return result;
+    }
+
+    // Функция получения количества инструкций на такт (IPC), если оба счётчика доступны
+    std::optional<double> instructions_per_cycle() const {
+        const auto& cycles = (*this)[Event::CYCLES];
+        const auto& instructions = (*this)[Event::INSTRUCTIONS];
+        if (cycles && instructions && *cycles > 0.0) return *instructions / *cycles;
+        return std::nullopt;
+    }
+};
+
+// Класс группы аппаратных счётчиков производительности для текущего потока и потоков, созданных им после
+// конструирования объекта (например, потоков std::async в сортировках)
+//
+// Каждое событие открывается отдельно, так что недоступность одного из них (например, в виртуальной машине
+// или при запрете через /proc/sys/kernel/perf_event_paranoid) не мешает измерять остальные, а при недоступности
+// всех событий измерение просто возвращает пустые значения. При нехватке аппаратных счётчиков ядро
+// мультиплексирует события, и их значения масштабируются пропорционально времени работы счётчика
+class PerfCounters {
+private:
+    std::array<int, EVENT_COUNT> files_; // Дескрипторы счётчиков (-1 для недоступных событий)
+
+#if defined(__linux__)
+    // Функция открытия счётчика события (возвращает -1, если событие недоступно)
+    static int open_event(uint32_t type, uint64_t config) {
+        perf_event_attr attr {};
+        attr.size           = sizeof(attr);
+        attr.type           = type;
+        attr.config         = config;
+        attr.disabled       = 1; // Счётчик запускается функцией start()
+        attr.inherit        = 1; // Учитывать потоки, созданные после открытия счётчика
+        attr.exclude_kernel = 1; // Только пользовательский код (обычно разрешено и при perf_event_paranoid = 2)
+        attr.exclude_hv     = 1;
+        attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    // Функция получения конфигурации события кэша (чтение, промах)
+    static constexpr uint64_t cache_miss_config(uint64_t cache) {
+        return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    }
+#endif
+
+public:
+    // Конструктор: открывает счётчики всех доступных событий
+    explicit PerfCounters() {
+        files_.fill(-1);
+
+#if defined(__linux__)
+        files_[static_cast<size_t>(Event::CYCLES)]        = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        files_[static_cast<size_t>(Event::INSTRUCTIONS)]  = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        files_[static_cast<size_t>(Event::BRANCH_MISSES)] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+        files_[static_cast<size_t>(Event::L1D_MISSES)]    = open_event(PERF_TYPE_HW_CACHE, cache_miss_config(PERF_COUNT_HW_CACHE_L1D));
+        files_[static_cast<size_t>(Event::LLC_MISSES)]    = open_event(PERF_TYPE_HW_CACHE, cache_miss_config(PERF_COUNT_HW_CACHE_LL));
+        files_[static_cast<size_t>(Event::DTLB_MISSES)]   = open_event(PERF_TYPE_HW_CACHE, cache_miss_config(PERF_COUNT_HW_CACHE_DTLB));
+#endif
+    }
+
+    // Копирование запрещено (объект владеет дескрипторами)
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator = (const PerfCounters&) = delete;
+
+    // Деструктор закрывает дескрипторы счётчиков
+    ~PerfCounters() {
+#if defined(__linux__)
+        for (int file : files_) if (file >= 0) close(file);
+#endif
+    }
+
+    // Функция проверки доступности события
+    bool available(Event event) const { return files_[static_cast<size_t>(event)] >= 0; }
+
+    // Функция проверки, доступно ли хотя бы одно событие
+    bool any_available() const {
+        for (int file : files_) if (file >= 0) return true;
+        return false;
+    }
+
+    // Функция сброса и запуска счётчиков
+    void start() {
+#if defined(__linux__)
+        for (int file : files_) if (file >= 0) ioctl(file, PERF_EVENT_IOC_RESET, 0);
+        for (int file : files_) if (file >= 0) ioctl(file, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+
+    // Функция остановки счётчиков
+    void stop() {
+#if defined(__linux__)
+        for (int file : files_) if (file >= 0) ioctl(file, PERF_EVENT_IOC_DISABLE, 0);
+#endif
+    }
+
+    // Функция чтения значений счётчиков (с учётом мультиплексирования)
+    PerfCounterValues read() const {
+        PerfCounterValues result;
+
+#if defined(__linux__)
+        for (size_t i = 0; i < EVENT_COUNT; ++i) {
+            if (files_[i] < 0) continue;
+
+            // Формат чтения: значение, время включения, время фактической работы счётчика
+            uint64_t data[3] = {};
+            if (::read(files_[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data))) continue;
+
+            if (data[2] == 0u) result.values[i] = 0.0;
+            else               result.values[i] = static_cast<double>(data[0]) * static_cast<double>(data[1]) / static_cast<double>(data[2]);
+        }
+#endif
+
+        return result;
+    }
+
+    // Функция измерения работы функции func (счётчики запускаются перед вызовом и останавливаются после него)
+    template <typename Function>
+    PerfCounterValues measure(Function&& func) {
+        start();
+        std::forward<Function>(func)();
+        stop();
+        return read();
+    }
+};
+
+// Функция измерения работы функции func с новой группой счётчиков
+template <typename Function>
+PerfCounterValues Measure(Function&& func) {
+    PerfCounters counters;
+    return counters.measure(std::forward<Function>(func));
+}
+
+// Перегрузка оператора "<<" для вывода значений счётчиков в поток ("n/a" для недоступных событий)
+inline std::ostream& operator << (std::ostream& os, const PerfCounterValues& values) {
+    using namespace std;
+
+    bool first = true;
+    for (size_t i = 0; i < EVENT_COUNT; ++i) {
+        if (first) first = false;
+        else       os << " "s;
+
+        os << EVENT_NAMES[i] << "="s;
+        // Большие значения выводятся целыми, а малые (например, после пересчёта на операцию) - с дробной частью
+        if (values.values[i]) os << fixed << setprecision(*values.values[i] >= 1000.0 ? 0 : 3) << *values.values[i] << defaultfloat;
+        else                  os << "n/a"s;
+    }
+
+    if (const auto ipc = values.instructions_per_cycle()) os << " ipc="s << fixed << setprecision(2) << *ipc << defaultfloat;
+
+    return os;
+}
+
+}
\ No newline at end of file
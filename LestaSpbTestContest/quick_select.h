@@ -0,0 +1,179 @@
+#pragma once
+#include <algorithm>
+#include <iterator>
+#include <vector>
+#include <future>
+#include <thread>
+#include <cmath>
+#include "in_place_quick_sort.h"
+
+namespace quick_select {
+
+// Размер полуинтервала, начиная с которого выборку дешевле закончить обычной сортировкой
+constexpr std::ptrdiff_t SMALL_RANGE_SIZE = 16;
+
+// Функция выборки n-го элемента (аналог std::nth_element) на основе разбиения из InPlaceQuickSortPartition:
+// после вызова на позиции nth стоит тот элемент, который стоял бы там после сортировки, слева от него
+// элементы не больше, а справа - не меньше его (в среднем O(N) вместо O(N log N) полной сортировки)
+template <typename RandomAccessIterator, typename Comparator>
+void NthElement(RandomAccessIterator begin, RandomAccessIterator nth, RandomAccessIterator end, Comparator comparator) {
+    using namespace std;
+    using namespace in_place_quick_sort;
+
+    if (nth == end) return;
+
+    // Допустимое число неудачных разбиений (2 log N), после которого переходим на std::nth_element,
+    // гарантирующий линейную сложность в худшем случае (аналогично тому, как intro sort переходит на heap sort)
+    int depth_limit = 2 * static_cast<int>(log2(static_cast<double>(distance(begin, end)) + 1.0));
+
+    // В отличие от сортировки, рекурсия не нужна: продолжаем разбиение только той части, где лежит nth
+    while (distance(begin, end) > SMALL_RANGE_SIZE) {
+        if (depth_limit-- == 0) { nth_element(begin, nth, end, comparator); return; }
+
+        // Ставим медиану из трёх в середину, где её возьмёт разбиение в качестве опорного элемента
+        MedianOfThreeToMiddle(begin, end, comparator);
+
+        // Элементы в [begin;pivot) не больше опорного, в [pivot;end) - не меньше
+        RandomAccessIterator pivot = InPlaceQuickSortPartition(begin, end, comparator);
+
+        if (nth < pivot) end   = pivot;
+        else             begin = pivot;
+    }
+
+    // Остаток досортировываем целиком
+    sort(begin, end, comparator);
+}
+
+// Перегрузка NthElement со стандартным компаратором
+template <typename RandomAccessIterator>
+void NthElement(RandomAccessIterator begin, RandomAccessIterator nth, RandomAccessIterator end) {
+    NthElement(begin, nth, end, std::less<typename std::iterator_traits<RandomAccessIterator>::value_type>());
+}
+
+// Функция частичной сортировки (аналог std::partial_sort): упорядочивает полуинтервал [begin;middle) так,
+// как он был бы упорядочен после сортировки всего [begin;end), а порядок элементов в [middle;end) не определён
+// (выборка O(N) плюс сортировка только первых K элементов O(K log K))
+template <typename RandomAccessIterator, typename Comparator>
+void PartialSort(RandomAccessIterator begin, RandomAccessIterator middle, RandomAccessIterator end, Comparator comparator) {
+    using namespace std;
+
+    if (begin == middle) return;
+
+    // Отделяем K первых элементов от остальных
+    if (middle != end) NthElement(begin, prev(middle), end, comparator);
+
+    // Сортируем только их той же параллельной быстрой сортировкой
+    const int max_async_depth = static_cast<int>(log(static_cast<double>(distance(begin, middle))));
+    in_place_quick_sort::InPlaceQuickSort(begin, middle, comparator, max_async_depth, 0);
+}
+
+// Перегрузка PartialSort со стандартным компаратором
+template <typename RandomAccessIterator>
+void PartialSort(RandomAccessIterator begin, RandomAccessIterator middle, RandomAccessIterator end) {
+    PartialSort(begin, middle, end, std::less<typename std::iterator_traits<RandomAccessIterator>::value_type>());
+}
+
+// Класс накопителя K лучших элементов из потока (лучшими считаются наименьшие по comparator, так что для
+// таблицы лидеров нужно передать std::greater). Хранит не более K элементов в куче, на вершине которой
+// худший из лучших, так что каждый новый элемент обрабатывается за O(log K), а память ограничена O(K)
+template <typename Type, typename Comparator = std::less<Type>>
+class TopKAccumulator {
+private:
+    std::vector<Type> heap_;     // Куча из не более, чем k_ лучших элементов (на вершине - худший из них)
+    size_t            k_ = 0u;   // Количество лучших элементов, которые нужно сохранить
+    Comparator        comparator_;
+
+public:
+    // Конструктор, принимающий количество сохраняемых элементов и компаратор
+    explicit TopKAccumulator(size_t k, Comparator comparator = Comparator()) : k_(k), comparator_(comparator) {
+        heap_.reserve(k_);
+    }
+
+    // Функция добавления элемента из потока
+    void push(const Type& value) {
+        using namespace std;
+
+        if (k_ == 0u) return;
+
+        // Покуда куча не заполнена, просто добавляем элемент
+        if (heap_.size() < k_) {
+            heap_.push_back(value);
+            push_heap(heap_.begin(), heap_.end(), comparator_);
+        }
+        // А иначе заменяем худший из сохранённых, если новый элемент лучше его
+        else if (comparator_(value, heap_.front())) {
+            pop_heap(heap_.begin(), heap_.end(), comparator_);
+            heap_.back() = value;
+            push_heap(heap_.begin(), heap_.end(), comparator_);
+        }
+    }
+
+    // Функция добавления элементов из диапазона [begin; end)
+    template <typename InputIterator>
+    void push(InputIterator begin, InputIterator end) {
+        for (; begin != end; ++begin) push(*begin);
+    }
+
+    // Функция слияния с другим накопителем (например, посчитанным в другом потоке)
+    void merge(const TopKAccumulator& other) {
+        for (const Type& value : other.heap_) push(value);
+    }
+
+    // Функция получения количества сохранённых элементов
+    size_t size() const { return heap_.size(); }
+
+    // Функция получения сохранённых элементов, упорядоченных от лучшего к худшему
+    std::vector<Type> sorted() const {
+        std::vector<Type> result(heap_);
+        std::sort_heap(result.begin(), result.end(), comparator_);
+        return result;
+    }
+};
+
+// Параллельная функция получения K лучших элементов диапазона [begin; end) без его изменения: диапазон
+// разбивается на куски по числу ядер, для каждого куска с помощью std::async считается свой накопитель,
+// после чего накопители сливаются (O(N log K / P) вместо O(N log N) полной сортировки копии)
+template <typename RandomAccessIterator, typename Comparator>
+std::vector<typename std::iterator_traits<RandomAccessIterator>::value_type>
+TopK(RandomAccessIterator begin, RandomAccessIterator end, size_t k, Comparator comparator) {
+    using namespace std;
+    using Accumulator = TopKAccumulator<typename iterator_traits<RandomAccessIterator>::value_type, Comparator>;
+
+    const size_t range_length = static_cast<size_t>(distance(begin, end));
+
+    // Количество кусков: по числу ядер, но так, чтобы каждый кусок был заметно больше K
+    const size_t max_chunks = max<size_t>(1u, range_length / max<size_t>(k * 4u, 1024u));
+    const size_t chunks     = min<size_t>(max<size_t>(1u, thread::hardware_concurrency()), max_chunks);
+    const size_t chunk_size = (range_length + chunks - 1u) / chunks;
+
+    // Запускаем накопление по всем кускам, кроме первого, параллельно
+    vector<future<Accumulator>> futures;
+    for (size_t chunk = 1u; chunk < chunks; ++chunk) {
+        RandomAccessIterator chunk_begin = begin + min(chunk * chunk_size, range_length);
+        RandomAccessIterator chunk_end   = begin + min((chunk + 1u) * chunk_size, range_length);
+
+        futures.push_back(async(launch::async, [chunk_begin, chunk_end, k, comparator] {
+            Accumulator accumulator(k, comparator);
+            accumulator.push(chunk_begin, chunk_end);
+            return accumulator;
+        }));
+    }
+
+    // Первый кусок обрабатываем в текущем потоке
+    Accumulator result(k, comparator);
+    result.push(begin, begin + min(chunk_size, range_length));
+
+    // Сливаем результаты
+    for (auto& f : futures) result.merge(f.get());
+
+    return result.sorted();
+}
+
+// Перегрузка TopK со стандартным компаратором (K наименьших элементов)
+template <typename RandomAccessIterator>
+std::vector<typename std::iterator_traits<RandomAccessIterator>::value_type>
+TopK(RandomAccessIterator begin, RandomAccessIterator end, size_t k) {
+    return TopK(begin, end, k, std::less<typename std::iterator_traits<RandomAccessIterator>::value_type>());
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,147 @@
+#pragma once
+#include <algorithm>
+#include <iterator>
+#include <vector>
+#include <chrono>
+#include <functional>
+
+namespace resumable_sort {
+
+// Класс возобновляемой сортировки слиянием для диапазона [begin; end): вместо рекурсии всё состояние сортировки
+// хранится явно, а работа выполняется порциями через step(budget), так что сортировку большого массива можно
+// растянуть на несколько кадров с жёстким ограничением времени на кадр
+//
+// Используется восходящая (bottom-up) сортировка слиянием: на каждом проходе сливаются соседние отсортированные
+// отрезки длины width в отрезки длины 2 * width, попеременно из диапазона в буфер и обратно. Единица работы -
+// один записанный элемент (не больше одного сравнения), поэтому стоимость одной единицы ограничена и постоянна.
+// Сортировка стабильная, память O(N) выделяется один раз в конструкторе
+template <typename RandomIt, typename Comparator = std::less<typename std::iterator_traits<RandomIt>::value_type>>
+class ResumableMergeSort {
+private:
+    using value_type = typename std::iterator_traits<RandomIt>::value_type;
+
+    // Этапы сортировки
+    enum class Phase {
+        MERGE,     // Проходы слияния
+        COPY_BACK, // Копирование результата из буфера обратно в диапазон (если последний проход писал в буфер)
+        DONE       // Сортировка закончена
+    };
+
+    RandomIt   begin_;
+    size_t     size_ = 0u;
+    Comparator comparator_;
+
+    std::vector<value_type> buffer_; // Буфер для слияния
+
+    Phase  phase_     = Phase::MERGE;
+    bool   to_range_  = true; // Пишет ли текущий проход в диапазон (а читает из буфера) или наоборот
+    size_t width_     = 1u;   // Длина отсортированных отрезков на текущем проходе
+
+    size_t left_      = 0u;   // Текущая позиция в левом  отрезке текущей пары
+    size_t left_end_  = 0u;   // Конец левого  отрезка текущей пары
+    size_t right_     = 0u;   // Текущая позиция в правом отрезке текущей пары
+    size_t right_end_ = 0u;   // Конец правого отрезка текущей пары
+    size_t output_    = 0u;   // Позиция записи
+
+    size_t total_work_ = 0u;  // Полный объём работы (в единицах) для оценки прогресса
+    size_t done_work_  = 0u;  // Выполненный объём работы
+
+    // Функции доступа к источнику и приёмнику текущего прохода
+    value_type& source(size_t index) { return to_range_ ? buffer_[index] : begin_[index]; }
+    value_type& target(size_t index) { return to_range_ ? begin_[index] : buffer_[index]; }
+
+    // Функция перехода к следующей паре отрезков, начинающейся с output_
+    void start_pair() {
+        using namespace std;
+
+        left_      = output_;
+        left_end_  = min(output_ + width_, size_);
+        right_     = left_end_;
+        right_end_ = min(output_ + 2u * width_, size_);
+    }
+
+    // Функция выполнения одной единицы работы (запись одного элемента результата)
+    void unit() {
+        using namespace std;
+
+        // Копирование результата из буфера обратно в диапазон
+        if (phase_ == Phase::COPY_BACK) {
+            begin_[output_] = move(buffer_[output_]);
+            ++done_work_;
+
+            if (++output_ == size_) phase_ = Phase::DONE;
+            return;
+        }
+
+        // Выбираем меньший из текущих элементов пары (при равенстве - из левого отрезка, для стабильности)
+        if (right_ < right_end_ && (left_ == left_end_ || comparator_(source(right_), source(left_)))) {
+            target(output_++) = move(source(right_++));
+        }
+        else {
+            target(output_++) = move(source(left_++));
+        }
+        ++done_work_;
+
+        // Если пара ещё не слита, продолжаем её
+        if (output_ < right_end_) return;
+
+        // Если проход ещё не закончен, переходим к следующей паре
+        if (output_ < size_) { start_pair(); return; }
+
+        // Проход закончен: удваиваем длину отрезков и меняем местами источник и приёмник
+        output_ = 0u;
+        width_ *= 2u;
+
+        if (width_ < size_) {
+            to_range_ = !to_range_;
+            start_pair();
+        }
+        // Если отрезок покрыл весь диапазон, сортировка закончена, но результат может оказаться в буфере
+        else phase_ = to_range_ ? Phase::DONE : Phase::COPY_BACK;
+    }
+
+public:
+    // Конструктор: запоминает диапазон и копирует его в буфер (O(N), сама сортировка в конструкторе не выполняется,
+    // так что объект можно создать заранее, вне кадра с ограничением времени)
+    explicit ResumableMergeSort(RandomIt begin, RandomIt end, Comparator comparator = Comparator()) : begin_(begin),
+                                                                                                      size_(static_cast<size_t>(std::distance(begin, end))),
+                                                                                                      comparator_(comparator),
+                                                                                                      buffer_(begin, end) {
+        // Количество проходов - ceil(log2 N), на каждом N записей, плюс ещё N записей на копирование
+        // результата обратно в диапазон, если последний проход писал в буфер (при чётном количестве проходов)
+        size_t passes = 0u;
+        for (size_t width = 1u; width < size_; width *= 2u) ++passes;
+        total_work_ = size_ * passes + (passes % 2u == 0u ? size_ : 0u);
+
+        // Диапазон из менее, чем 2 элементов, уже отсортирован
+        if (passes == 0u) { phase_ = Phase::DONE; total_work_ = 0u; return; }
+
+        start_pair();
+    }
+
+    // Функция проверки, закончена ли сортировка
+    bool done() const { return phase_ == Phase::DONE; }
+
+    // Функция получения прогресса сортировки в диапазоне [0; 1]
+    double progress() const { return total_work_ ? static_cast<double>(done_work_) / static_cast<double>(total_work_) : 1.0; }
+
+    // Функция выполнения не более budget единиц работы (сравнений и перемещений элементов),
+    // возвращает true, если сортировка закончена
+    bool step(size_t budget) {
+        for (size_t i = 0; i < budget && !done(); ++i) unit();
+        return done();
+    }
+
+    // Функция выполнения работы в течение не более, чем budget времени, возвращает true, если сортировка закончена
+    // (время проверяется раз в check_interval единиц работы, чтобы не тратить время на сами замеры)
+    bool step(std::chrono::nanoseconds budget, size_t check_interval = 256u) {
+        using namespace std::chrono;
+
+        const auto deadline = steady_clock::now() + budget;
+        while (!done() && steady_clock::now() < deadline) step(check_interval);
+
+        return done();
+    }
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,243 @@
+#pragma once
+#include <iostream>
+#include <string>
+#include <utility>
+#include <stdexcept>
+#include "array_ptr.h"
+#include "dynamic_ring_buffer_deque.h"
+
+namespace segmented_ring_buffer_deque {
+
+// Размер блока по умолчанию: около 4 КБ, но не меньше 16 элементов
+template <typename Type>
+constexpr size_t DEFAULT_BLOCK_SIZE = sizeof(Type) < 256u ? 4096u / sizeof(Type) : 16u;
+
+// Класс сегментированного дека с ограниченной задержкой роста: элементы хранятся в блоках фиксированного размера
+// block_size_, а указатели на блоки - в карте блоков (динамическом деке на кольцевом буфере)
+//
+// В отличие от DynamicRingBufferDeque, при росте элементы никогда не перемещаются: добавление элемента в худшем
+// случае выделяет один новый блок (а чаще берёт запасной) и добавляет указатель в карту. Сама карта растёт
+// удвоением, но она в block_size_ раз меньше дека (для дека из 10^7 чисел int - около 10^4 указателей), а функция
+// reserve() позволяет заранее зарезервировать её, так что задержка добавления не зависит от размера дека
+//
+//  blocks_: [*][*][*]           <- карта блоков (DynamicRingBufferDeque<Type*>)
+//            |  |  |
+//           [ ][ ][0][1]        <- блок 0, head_offset_ = 2
+//              [2][3][4][5]     <- блок 1
+//                 [6][7][ ][ ]  <- блок 2
+template <typename Type, size_t block_size_ = DEFAULT_BLOCK_SIZE<Type>>
+class SegmentedRingBufferDeque {
+private:
+    static_assert(block_size_ > 0u, "segmented-ring-buffer-deque block size must be positive");
+
+    dynamic_ring_buffer_deque::DynamicRingBufferDeque<Type*> blocks_; // Карта блоков
+
+    Type*  spare_block_ = nullptr; // Запасной блок (чтобы не выделять и не освобождать блок на границе при чередовании push/pop)
+    size_t size_        = 0u;      // Размер дека
+    size_t head_offset_ = 0u;      // Индекс первого элемента в первом блоке
+
+    // Функция получения блока (запасного или нового)
+    Type* acquire_block() {
+        if (spare_block_) return std::exchange(spare_block_, nullptr);
+        return array_ptr::ArrayPtr<Type>(block_size_).release();
+    }
+
+    // Функция возврата блока (становится запасным, если запасного ещё нет)
+    void release_block(Type* block) noexcept {
+        if (!spare_block_) spare_block_ = block;
+        else               delete[] block;
+    }
+
+    // Функция освобождения всех блоков
+    void release_all_blocks() noexcept {
+        while (!blocks_.empty()) release_block(blocks_.pop_back());
+        head_offset_ = 0u;
+    }
+
+    // Функция получения ссылки на элемент по позиции, отсчитанной от начала первого блока
+    Type& at_position(size_t position) { return blocks_[position / block_size_][position % block_size_]; }
+    const Type& at_position(size_t position) const { return blocks_[position / block_size_][position % block_size_]; }
+
+    // Функция добавления нового блока в конец (push_back) или начало (push_front) карты: если при росте карты
+    // выбрасывается исключение, блок возвращается (становится запасным или освобождается), а не теряется
+    template <typename Push>
+    void push_block(Push push) {
+        Type* block = acquire_block();
+
+        try {
+            push(block);
+        }
+        catch (...) {
+            release_block(block);
+            throw;
+        }
+    }
+
+    // Функция подготовки места в конце дека
+    void prepare_back() {
+        if (head_offset_ + size_ == blocks_.size() * block_size_) push_block([this](Type* block) { blocks_.push_back(block); });
+    }
+
+    // Функция подготовки места в начале дека
+    void prepare_front() {
+        if (head_offset_ == 0u) {
+            push_block([this](Type* block) { blocks_.push_front(block); });
+            head_offset_ = block_size_;
+        }
+    }
+
+public:
+    // Конструктор по умолчанию создаёт пустой дек
+    explicit SegmentedRingBufferDeque() = default;
+
+    // Копирование запрещено (при необходимости дек можно скопировать поэлементно)
+    SegmentedRingBufferDeque(const SegmentedRingBufferDeque&) = delete;
+    SegmentedRingBufferDeque& operator = (const SegmentedRingBufferDeque&) = delete;
+
+    // Конструктор перемещения
+    SegmentedRingBufferDeque(SegmentedRingBufferDeque&& rvalue) noexcept { swap(rvalue); }
+
+    // Оператор присвоения с перемещением
+    SegmentedRingBufferDeque& operator = (SegmentedRingBufferDeque&& rvalue) noexcept { swap(rvalue); return *this; }
+
+    // Деструктор освобождает все блоки
+    ~SegmentedRingBufferDeque() {
+        while (!blocks_.empty()) delete[] blocks_.pop_back();
+        delete[] spare_block_;
+    }
+
+    // Функция обмена с другим деком
+    void swap(SegmentedRingBufferDeque& other) noexcept {
+        blocks_.swap(other.blocks_);
+        std::swap(spare_block_, other.spare_block_);
+        std::swap(size_, other.size_);
+        std::swap(head_offset_, other.head_offset_);
+    }
+
+    // Функция резервирования карты блоков под capacity элементов (сами блоки выделяются по мере надобности),
+    // после которой добавление элементов до этого размера не вызывает реаллокаций карты
+    void reserve(size_t capacity) { blocks_.reserve(capacity / block_size_ + 2u); }
+
+    // Функция очистки дека
+    void clear() {
+        release_all_blocks();
+        size_ = 0u;
+    }
+
+    // Функция получения размера
+    size_t size() const { return size_; }
+
+    // Функция проверки на пустоту
+    bool empty() const { return size_ == 0u; }
+
+    // Функция добавления в конец (копирование lvalue в конец)
+    void push_back(const Type& lvalue) {
+        prepare_back();
+        at_position(head_offset_ + size_) = lvalue;
+        ++size_;
+    }
+
+    // Функция перемещения в конец (перемещение rvalue в конец)
+    void push_back(Type&& rvalue) {
+        prepare_back();
+        at_position(head_offset_ + size_) = std::move(rvalue);
+        ++size_;
+    }
+
+    // Функция добавления в начало (копирование lvalue в начало)
+    void push_front(const Type& lvalue) {
+        prepare_front();
+        blocks_[0][head_offset_ - 1u] = lvalue;
+        --head_offset_;
+        ++size_;
+    }
+
+    // Функция перемещения в начало (перемещение rvalue в начало)
+    void push_front(Type&& rvalue) {
+        prepare_front();
+        blocks_[0][head_offset_ - 1u] = std::move(rvalue);
+        --head_offset_;
+        ++size_;
+    }
+
+    // Функция удаления из конца
+    Type pop_back() {
+        using namespace std;
+
+        // В случае пустого дека выбразываем исключение
+        if (empty()) throw out_of_range("pop_back() call from empty segmented-ring-buffer-deque"s);
+
+        --size_;
+        const size_t position = head_offset_ + size_;
+        Type value = move(at_position(position));
+
+        // Если дек опустел, освобождаем все блоки, а если опустел последний блок - только его
+        if (size_ == 0u)                      release_all_blocks();
+        else if (position % block_size_ == 0u) release_block(blocks_.pop_back());
+
+        return value;
+    }
+
+    // Функция удаления из начала
+    Type pop_front() {
+        using namespace std;
+
+        // В случае пустого дека выбразываем исключение
+        if (empty()) throw out_of_range("pop_front() call from empty segmented-ring-buffer-deque"s);
+
+        Type value = move(blocks_[0][head_offset_]);
+        ++head_offset_;
+        --size_;
+
+        // Если дек опустел, освобождаем все блоки, а если опустел первый блок - только его
+        if (size_ == 0u) release_all_blocks();
+        else if (head_offset_ == block_size_) {
+            release_block(blocks_.pop_front());
+            head_offset_ = 0u;
+        }
+
+        return value;
+    }
+
+    // Функция получения ссылки на элемент с определённым индексом
+    Type& operator [] (size_t index) {
+        using namespace std;
+
+        // В случае попытки получения ссылки на элемент с индексом за границей диапазона значений дека, выбразываем исключение
+        if (index >= size_) throw out_of_range("operator [] call for out of range index"s);
+
+        return at_position(head_offset_ + index);
+    }
+
+    // Функция получения константной ссылки на элемент с определённым индексом
+    // (аналогична предыдущей, но для константных деков)
+    const Type& operator [] (size_t index) const {
+        using namespace std;
+
+        // В случае попытки получения ссылки на элемент с индексом за границей диапазона значений дека, выбразываем исключение
+        if (index >= size_) throw out_of_range("operator [] call for out of range index"s);
+
+        return at_position(head_offset_ + index);
+    }
+};
+
+// Перегрузка оператора "<<" для вывода элементов дека в поток
+template <typename Type, size_t block_size_>
+std::ostream& operator << (std::ostream& os, const SegmentedRingBufferDeque<Type, block_size_>& segmented_deque) {
+    using namespace std;
+
+    os << "["s;
+    bool first = true;
+
+    for (size_t index = 0; index < segmented_deque.size(); ++index) {
+        if (first) first = false;
+        else       os << ", "s;
+        os << segmented_deque[index];
+    }
+
+    os << "]"s;
+
+    return os;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,308 @@
+#pragma once
+#include <iterator>
+#include <string>
+#include <utility>
+#include <functional>
+#include <stdexcept>
+#include <cmath>
+#include "static_ring_buffer_deque.h"
+
+namespace sliding_window {
+
+// Функция пропуска элементов начала пачки [begin; end), которые всё равно были бы вытеснены из окна
+// размера window (остаются только последние window элементов), возвращает количество пропущенных элементов
+template <typename ForwardIt>
+size_t SkipEvicted(ForwardIt& begin, ForwardIt end, size_t window) {
+    const auto batch_size = static_cast<size_t>(std::distance(begin, end));
+    if (batch_size <= window) return 0u;
+
+    std::advance(begin, batch_size - window);
+    return batch_size - window;
+}
+
+// Класс скользящего минимума (или максимума, в зависимости от компаратора) по последним window_ значениям
+//
+// Используется монотонный дек: в нём хранятся только значения, которые ещё могут стать экстремумом окна (каждое
+// следующее "хуже" предыдущего по компаратору), поэтому экстремум окна - всегда первый элемент. Новое значение
+// вытесняет из конца все значения, которые не лучше него, а из начала уходят значения, вышедшие за окно. Каждое
+// значение добавляется и удаляется не больше одного раза, так что push() выполняется за амортизированное O(1)
+template <typename Type, size_t window_, typename Comparator = std::less<Type>>
+class SlidingWindowExtremum {
+private:
+    static_assert(window_ > 0u, "sliding window size must be positive");
+
+    // Кандидаты в экстремум: порядковый номер значения в потоке и само значение
+    static_ring_buffer_deque::StaticRingBufferDeque<std::pair<size_t, Type>, window_> candidates_;
+
+    size_t     count_ = 0u; // Количество значений, добавленных за всё время
+    Comparator comparator_;
+
+public:
+    explicit SlidingWindowExtremum(Comparator comparator = Comparator()) : comparator_(comparator) {}
+
+    // Функция получения количества значений в окне
+    size_t size() const { return count_ < window_ ? count_ : window_; }
+
+    // Функция проверки на пустоту
+    bool empty() const { return count_ == 0u; }
+
+    // Функция очистки окна
+    void clear() { candidates_.clear(); count_ = 0u; }
+
+    // Функция добавления значения (самое старое значение окна вытесняется)
+    void push(const Type& value) {
+        // Удаляем из начала кандидата, выходящего за окно
+        if (!candidates_.is_empty() && candidates_[0].first + window_ <= count_) candidates_.pop_front();
+
+        // Удаляем из конца кандидатов, которые не лучше нового значения (они уже никогда не станут экстремумом)
+        while (!candidates_.is_empty() && !comparator_(candidates_[candidates_.size() - 1u].second, value)) candidates_.pop_back();
+
+        candidates_.push_back({ count_, value });
+        ++count_;
+    }
+
+    // Функция пакетного добавления значений из диапазона [begin; end): значения, которые всё равно
+    // были бы вытеснены из окна, не обрабатываются
+    template <typename ForwardIt>
+    void push(ForwardIt begin, ForwardIt end) {
+        if (const size_t skipped = SkipEvicted(begin, end, window_)) {
+            candidates_.clear();
+            count_ += skipped;
+        }
+
+        for (; begin != end; ++begin) push(*begin);
+    }
+
+    // Функция получения экстремума окна
+    const Type& value() const {
+        using namespace std;
+
+        // В случае пустого окна выбразываем исключение
+        if (empty()) throw out_of_range("value() call for empty sliding window"s);
+
+        return candidates_[0].second;
+    }
+};
+
+// Скользящий минимум и максимум
+template <typename Type, size_t window_>
+using SlidingWindowMin = SlidingWindowExtremum<Type, window_, std::less<Type>>;
+
+template <typename Type, size_t window_>
+using SlidingWindowMax = SlidingWindowExtremum<Type, window_, std::greater<Type>>;
+
+// Класс скользящей агрегации по последним window_ значениям для любой ассоциативной операции
+// (сумма, произведение, минимум, НОД, композиция преобразований и т.д., обратная операция не требуется)
+//
+// Используется очередь на двух стеках (SWAG): окно делится на "переднюю" часть, для которой хранятся агрегаты
+// суффиксов (front_aggregates_[i] = values_[i] * ... * values_[front_size - 1]), и "заднюю" часть, для которой
+// хранится один агрегат back_aggregate_. Добавление обновляет агрегат задней части, вытеснение удаляет первый
+// суффикс передней части, а когда передняя часть кончается, вся задняя часть становится передней с пересчётом
+// суффиксов. Каждое значение пересчитывается не больше одного раза, так что push() выполняется за
+// амортизированное O(1) применений операции, а aggregate() - за одно применение
+template <typename Type, size_t window_, typename Operation = std::plus<Type>>
+class SlidingWindowAggregate {
+private:
+    static_assert(window_ > 0u, "sliding window size must be positive");
+
+    static_ring_buffer_deque::StaticRingBufferDeque<Type, window_> values_;           // Значения окна
+    static_ring_buffer_deque::StaticRingBufferDeque<Type, window_> front_aggregates_; // Агрегаты суффиксов передней части
+
+    Type      back_aggregate_ = {}; // Агрегат задней части (значения values_[front_aggregates_.size(); values_.size()))
+    Operation operation_;
+
+    // Функция получения размера задней части
+    size_t back_size() const { return values_.size() - front_aggregates_.size(); }
+
+    // Функция переноса задней части в переднюю с пересчётом агрегатов суффиксов
+    void flip() {
+        front_aggregates_.clear();
+
+        for (size_t index = values_.size(); index-- > 0u;) {
+            if (front_aggregates_.is_empty()) front_aggregates_.push_front(values_[index]);
+            else                              front_aggregates_.push_front(operation_(values_[index], front_aggregates_[0]));
+        }
+    }
+
+    // Функция вытеснения самого старого значения
+    void evict() {
+        if (front_aggregates_.is_empty()) flip();
+
+        values_.pop_front();
+        front_aggregates_.pop_front();
+    }
+
+public:
+    explicit SlidingWindowAggregate(Operation operation = Operation()) : operation_(operation) {}
+
+    // Функция получения количества значений в окне
+    size_t size() const { return values_.size(); }
+
+    // Функция проверки на пустоту
+    bool empty() const { return values_.is_empty(); }
+
+    // Функция очистки окна
+    void clear() { values_.clear(); front_aggregates_.clear(); }
+
+    // Функция добавления значения (самое старое значение окна вытесняется)
+    void push(const Type& value) {
+        if (!values_.is_capacity_enough()) evict();
+
+        back_aggregate_ = back_size() == 0u ? value : operation_(back_aggregate_, value);
+        values_.push_back(value);
+    }
+
+    // Функция пакетного добавления значений из диапазона [begin; end): значения, которые всё равно
+    // были бы вытеснены из окна, не обрабатываются
+    template <typename ForwardIt>
+    void push(ForwardIt begin, ForwardIt end) {
+        if (SkipEvicted(begin, end, window_)) clear();
+
+        for (; begin != end; ++begin) push(*begin);
+    }
+
+    // Функция получения агрегата окна (в порядке значений: от самого старого к самому новому)
+    Type aggregate() const {
+        using namespace std;
+
+        // В случае пустого окна выбразываем исключение
+        if (empty()) throw out_of_range("aggregate() call for empty sliding window"s);
+
+        if (front_aggregates_.is_empty()) return back_aggregate_;
+        if (back_size() == 0u)            return front_aggregates_[0];
+
+        return operation_(front_aggregates_[0], back_aggregate_);
+    }
+};
+
+// Класс скользящих среднего и дисперсии по последним window_ значениям
+//
+// Среднее и сумма квадратов отклонений обновляются по формулам Уэлфорда при добавлении и вытеснении значения
+// (за O(1), без накопления сумм квадратов, теряющих точность при большом среднем). Чтобы ошибки округления
+// не накапливались на длинных потоках, после каждых window_ вытеснений статистика пересчитывается по окну
+// заново, что тоже даёт амортизированное O(1)
+template <typename Type, size_t window_>
+class SlidingWindowStatistics {
+private:
+    static_assert(window_ > 0u, "sliding window size must be positive");
+
+    static_ring_buffer_deque::StaticRingBufferDeque<Type, window_> values_; // Значения окна
+
+    double mean_               = 0.0; // Среднее
+    double squared_deviations_ = 0.0; // Сумма квадратов отклонений от среднего
+    size_t evictions_          = 0u;  // Количество вытеснений после последнего пересчёта
+
+    // Функция пересчёта статистики по окну заново (двухпроходным алгоритмом)
+    void recompute() {
+        const size_t count = values_.size();
+
+        mean_ = 0.0;
+        for (size_t index = 0; index < count; ++index) mean_ += static_cast<double>(values_[index]);
+        mean_ /= static_cast<double>(count);
+
+        squared_deviations_ = 0.0;
+        for (size_t index = 0; index < count; ++index) {
+            const double deviation = static_cast<double>(values_[index]) - mean_;
+            squared_deviations_ += deviation * deviation;
+        }
+
+        evictions_ = 0u;
+    }
+
+public:
+    explicit SlidingWindowStatistics() = default;
+
+    // Функция получения количества значений в окне
+    size_t size() const { return values_.size(); }
+
+    // Функция проверки на пустоту
+    bool empty() const { return values_.is_empty(); }
+
+    // Функция очистки окна
+    void clear() {
+        values_.clear();
+        mean_ = 0.0;
+        squared_deviations_ = 0.0;
+        evictions_ = 0u;
+    }
+
+    // Функция добавления значения (самое старое значение окна вытесняется)
+    void push(const Type& value) {
+        const double x = static_cast<double>(value);
+
+        // Вытесняем самое старое значение
+        if (!values_.is_capacity_enough()) {
+            const double y = static_cast<double>(values_.pop_front());
+
+            if (values_.is_empty()) { mean_ = 0.0; squared_deviations_ = 0.0; }
+            else {
+                const double delta = y - mean_;
+                mean_ -= delta / static_cast<double>(values_.size());
+                squared_deviations_ -= delta * (y - mean_);
+            }
+
+            ++evictions_;
+        }
+
+        // Добавляем новое значение
+        values_.push_back(value);
+        const double delta = x - mean_;
+        mean_ += delta / static_cast<double>(values_.size());
+        squared_deviations_ += delta * (x - mean_);
+
+        if (evictions_ == window_) recompute();
+    }
+
+    // Функция пакетного добавления значений из диапазона [begin; end): значения, которые всё равно
+    // были бы вытеснены из окна, не обрабатываются
+    template <typename ForwardIt>
+    void push(ForwardIt begin, ForwardIt end) {
+        if (SkipEvicted(begin, end, window_)) {
+            values_.clear();
+            for (; begin != end; ++begin) values_.push_back(*begin);
+            recompute();
+        }
+        else {
+            for (; begin != end; ++begin) push(*begin);
+        }
+    }
+
+    // Функция получения суммы значений окна
+    double sum() const { return mean_ * static_cast<double>(values_.size()); }
+
+    // Функция получения среднего
+    double mean() const {
+        using namespace std;
+
+        // В случае пустого окна выбразываем исключение
+        if (empty()) throw out_of_range("mean() call for empty sliding window"s);
+
+        return mean_;
+    }
+
+    // Функция получения дисперсии (генеральной, с делением на количество значений)
+    double variance() const {
+        using namespace std;
+
+        // В случае пустого окна выбразываем исключение
+        if (empty()) throw out_of_range("variance() call for empty sliding window"s);
+
+        // Из-за ошибок округления сумма квадратов отклонений может оказаться чуть меньше нуля
+        return squared_deviations_ > 0.0 ? squared_deviations_ / static_cast<double>(values_.size()) : 0.0;
+    }
+
+    // Функция получения выборочной дисперсии (с делением на количество значений минус один)
+    double sample_variance() const {
+        using namespace std;
+
+        // Для выборочной дисперсии нужно хотя бы два значения
+        if (values_.size() < 2u) throw out_of_range("sample_variance() call for sliding window with less than two values"s);
+
+        return squared_deviations_ > 0.0 ? squared_deviations_ / static_cast<double>(values_.size() - 1u) : 0.0;
+    }
+
+    // Функция получения стандартного отклонения
+    double standard_deviation() const { return std::sqrt(variance()); }
+};
+
+}
@@ -3,11 +3,31 @@
 #include <array>
 #include <string>
 #include <stdexcept>
+#include <type_traits>
+#include <cstdio>
+#include <cstdlib>
 
 namespace static_ring_buffer_deque {
 
+// Политика обработки ошибок по умолчанию: выбрасывание исключений
+struct ThrowErrorPolicy {
+    [[noreturn]] static void overflow(const char* message)     { throw std::overflow_error(message); }
+    [[noreturn]] static void out_of_range(const char* message) { throw std::out_of_range(message); }
+};
+
+// Политика обработки ошибок без исключений (например, для сборок с -fno-exceptions): вывод сообщения и аварийное завершение
+struct AbortErrorPolicy {
+    [[noreturn]] static void overflow(const char* message)     { std::fputs(message, stderr); std::fputc('\n', stderr); std::abort(); }
+    [[noreturn]] static void out_of_range(const char* message) { std::fputs(message, stderr); std::fputc('\n', stderr); std::abort(); }
+};
+
 // Класс статического дека на кольцевом буфере
-template <typename Type, size_t capacity_>
+//
+// Все функции дека constexpr, так что его можно заполнить на этапе компиляции и хранить в constexpr-переменной
+// (в .rodata, без инициализации при запуске). Ошибки (переполнение, пустой дек, индекс за границей) передаются
+// политике ErrorPolicy: её функции не constexpr, поэтому ошибка при вычислении на этапе компиляции становится
+// ошибкой компиляции, а во время выполнения обрабатывается политикой (по умолчанию - исключением, как и раньше)
+template <typename Type, size_t capacity_, typename ErrorPolicy = ThrowErrorPolicy>
 class StaticRingBufferDeque {
 private:
     std::array<Type, capacity_> buff_ = {}; // Буфер данных
@@ -17,7 +37,7 @@ private:
 
     // Функция инкремента со взятием по модулю capacity_
     // (заменяет оператор ++ для итератора по контейнеру)
-    size_t increment_cycle(size_t pos) const {
+    constexpr size_t increment_cycle(size_t pos) const {
 
         // В случае, если будет инкрементирован индекс, указывающий на последний элемент
         // в буфере данных, он перескочит на начальный элемент в буфере
@@ -26,7 +46,7 @@ private:
 
     // Функция декремента со взятием по модулю capacity_
     // (заменяет оператор -- для итератора по контейнеру)
-    size_t decrement_cycle(size_t pos) const {
+    constexpr size_t decrement_cycle(size_t pos) const {
 
         // В случае, если будет декрементирован индекс, указывающий на начальный элемент
         // в буфере данных, он перескочит на последний элемент в буфере
@@ -36,66 +56,93 @@ private:
 public:
     // Конструктор по умолчанию, сгенерированный автоматически, подойдёт
     // (по умолчанию генерируется пустой дек)
-    explicit StaticRingBufferDeque() = default;
+    constexpr explicit StaticRingBufferDeque() = default;
 
     // Конструктор копирования, сгенерированный автоматически, подойдёт, так как в heap'е мы ничего не храним
-    StaticRingBufferDeque(const StaticRingBufferDeque<Type, capacity_>&) = default;
+    constexpr StaticRingBufferDeque(const StaticRingBufferDeque&) = default;
 
     // Конструктор перемещения, сгенерированный автоматически, подойдёт, так как в heap'е мы ничего не храним
-    StaticRingBufferDeque(StaticRingBufferDeque<Type, capacity_>&&) noexcept = default;
+    constexpr StaticRingBufferDeque(StaticRingBufferDeque&&) noexcept = default;
 
     // Оператор присвоения с копированием, сгенерированный автоматически, подойдёт, так как в heap'е мы ничего не храним
-    StaticRingBufferDeque<Type, capacity_>& operator=(const StaticRingBufferDeque<Type, capacity_>&) = default;
+    constexpr StaticRingBufferDeque& operator=(const StaticRingBufferDeque&) = default;
 
     // Оператор присвоения с перемещением, сгенерированный автоматически, подойдёт, так как в heap'е мы ничего не храним
-    StaticRingBufferDeque<Type, capacity_>& operator=(StaticRingBufferDeque<Type, capacity_>&&) noexcept = default;
+    constexpr StaticRingBufferDeque& operator=(StaticRingBufferDeque&&) noexcept = default;
 
     // Нетривиальный деструктор не требуется, так как в heap'е мы ничего не храним
     ~StaticRingBufferDeque() = default;
 
     // Функция получения размера
-    size_t size() const { return size_; }
+    constexpr size_t size() const { return size_; }
 
     // Функция проверки на пустоту
-    bool is_empty() const { return size_ == 0u; }
+    constexpr bool is_empty() const { return size_ == 0u; }
 
     // Функция проверки, хватает ли ещё места в буфере для нового элемента
-    bool is_capacity_enough() const { return size_ != capacity_; }
+    constexpr bool is_capacity_enough() const { return size_ != capacity_; }
+
+    // Функция очистки дека (просто сбрасываем размер на ноль, не трогая буфер)
+    constexpr void clear() { size_ = 0u; head_index_ = 0u; }
 
     // Функция добавления в конец (копирование lvalue в конец)
-    void push_back(const Type& lvalue) {
+    constexpr void push_back(const Type& lvalue) {
         using namespace std;
 
-        // В случае отсутствия места выбразываем исключение
-        // (также можно было бы поставить assert(is_capacity_enough()) для DEBUG-конфигурации,
-        // возможно использование механизма исключений на таком уровне нецелесообразно)
-        if (!is_capacity_enough()) throw overflow_error("static-ring-buffer-deque capacity is not enough for push_back() call"s);
+        // В случае отсутствия места сообщаем об ошибке политике ErrorPolicy
+        // (по умолчанию выбрасывается исключение, а AbortErrorPolicy подходит для сборок без исключений)
+        if (!is_capacity_enough()) ErrorPolicy::overflow("static-ring-buffer-deque capacity is not enough for push_back() call");
              
         buff_[(head_index_ + size_) % capacity_] = lvalue; // Cначала копируем значение в конец диапазона 
         ++size_;                                           // Затем увеличиваем размер
     }
 
     // Функция перемещения в конец (перемещение rvalue в конец) 
-    void push_back(Type&& rvalue) {
+    constexpr void push_back(Type&& rvalue) {
         using namespace std;
 
-        // В случае отсутствия места выбразываем исключение
-        // (также можно было бы поставить assert(is_capacity_enough()) для DEBUG-конфигурации,
-        // возможно использование механизма исключений на таком уровне нецелесообразно)
-        if (!is_capacity_enough()) throw overflow_error("static-ring-buffer-deque capacity is not enough for push_back() call"s);
+        // В случае отсутствия места сообщаем об ошибке политике ErrorPolicy
+        // (по умолчанию выбрасывается исключение, а AbortErrorPolicy подходит для сборок без исключений)
+        if (!is_capacity_enough()) ErrorPolicy::overflow("static-ring-buffer-deque capacity is not enough for push_back() call");
 
         buff_[(head_index_ + size_) % capacity_] = move(rvalue); // Cначала перемещаем значение в конец диапазона 
         ++size_;                                                 // Затем увеличиваем размер
     }
 
+    // Функция добавления в конец с перезаписью самого старого элемента (копирование lvalue в конец)
+    // (режим "бортового самописца": при заполненном буфере не выбрасывает исключение, а вытесняет
+    // элемент из начала, возвращает true, если такое вытеснение произошло)
+    constexpr bool push_back_overwrite(const Type& lvalue) noexcept(std::is_nothrow_copy_assignable_v<Type>) {
+        const bool overwrite = !is_capacity_enough();
+
+        buff_[(head_index_ + size_) % capacity_] = lvalue; // Копируем значение в конец диапазона (при заполненном буфере - поверх начала)
+
+        if (overwrite) head_index_ = increment_cycle(head_index_); // Если буфер был заполнен, начало диапазона смещается на следующий элемент
+        else           ++size_;                                    // А иначе увеличиваем размер
+
+        return overwrite;
+    }
+
+    // Функция перемещения в конец с перезаписью самого старого элемента (перемещение rvalue в конец)
+    // (аналогична предыдущей)
+    constexpr bool push_back_overwrite(Type&& rvalue) noexcept(std::is_nothrow_move_assignable_v<Type>) {
+        const bool overwrite = !is_capacity_enough();
+
+        buff_[(head_index_ + size_) % capacity_] = std::move(rvalue); // Перемещаем значение в конец диапазона (при заполненном буфере - поверх начала)
+
+        if (overwrite) head_index_ = increment_cycle(head_index_); // Если буфер был заполнен, начало диапазона смещается на следующий элемент
+        else           ++size_;                                    // А иначе увеличиваем размер
+
+        return overwrite;
+    }
+
     // Функция добавления в начало (копирование lvalue в начало)
-    void push_front(const Type& lvalue) {
+    constexpr void push_front(const Type& lvalue) {
         using namespace std;
 
-        // В случае отсутствия места выбразываем исключение
-        // (также можно было бы поставить assert(is_capacity_enough()) для DEBUG-конфигурации,
-        // возможно использование механизма исключений на таком уровне нецелесообразно)
-        if (!is_capacity_enough()) throw overflow_error("static-ring-buffer-deque capacity is not enough for push_front() call"s);
+        // В случае отсутствия места сообщаем об ошибке политике ErrorPolicy
+        // (по умолчанию выбрасывается исключение, а AbortErrorPolicy подходит для сборок без исключений)
+        if (!is_capacity_enough()) ErrorPolicy::overflow("static-ring-buffer-deque capacity is not enough for push_front() call");
 
         head_index_ = decrement_cycle(head_index_); // Сначала смещаем индекс начала диапазона и "вращаем барабан" (декремент + взятие по модулю)
         buff_[head_index_] = lvalue;                // Затем копируем значение в начало диапазона
@@ -103,13 +150,12 @@ public:
     }
 
     // Функция перемещения в начало (перемещение rvalue в начало)
-    void push_front(Type&& rvalue) {
+    constexpr void push_front(Type&& rvalue) {
         using namespace std;
 
-        // В случае отсутствия места выбразываем исключение
-        // (также можно было бы поставить assert(is_capacity_enough()) для DEBUG-конфигурации,
-        // возможно использование механизма исключений на таком уровне нецелесообразно)
-        if (!is_capacity_enough()) throw overflow_error("static-ring-buffer-deque capacity is not enough for push_front() call"s);
+        // В случае отсутствия места сообщаем об ошибке политике ErrorPolicy
+        // (по умолчанию выбрасывается исключение, а AbortErrorPolicy подходит для сборок без исключений)
+        if (!is_capacity_enough()) ErrorPolicy::overflow("static-ring-buffer-deque capacity is not enough for push_front() call");
 
         head_index_ = decrement_cycle(head_index_); // Сначала смещаем индекс начала диапазона и "вращаем барабан" (декремент + взятие по модулю)
         buff_[head_index_] = move(rvalue);          // Затем перемещаем значение в начало диапазона
@@ -117,26 +163,24 @@ public:
     }
 
     // Функция удаления из конца
-    Type pop_back() {
+    constexpr Type pop_back() {
         using namespace std;
 
-        // В случае пустого дека выбразываем исключение
-        // (также можно было бы поставить assert(!is_empty()) для DEBUG-конфигурации,
-        // возможно использование механизма исключений на таком уровне нецелесообразно)
-        if (is_empty()) throw out_of_range("pop_back() call from empty static-ring-buffer-deque"s);
+        // В случае пустого дека сообщаем об ошибке политике ErrorPolicy
+        // (по умолчанию выбрасывается исключение, а AbortErrorPolicy подходит для сборок без исключений)
+        if (is_empty()) ErrorPolicy::out_of_range("pop_back() call from empty static-ring-buffer-deque");
 
         --size_;                                         // Сначала уменьшаем размер
         return buff_[(head_index_ + size_) % capacity_]; // Затем забираем и возвращаем значение из конца диапазона
     }
 
     // Функция удаления из начала
-    Type pop_front() {
+    constexpr Type pop_front() {
         using namespace std;
 
-        // В случае пустого дека выбразываем исключение
-        // (также можно было бы поставить assert(!is_empty()) для DEBUG-конфигурации,
-        // возможно использование механизма исключений на таком уровне нецелесообразно)
-        if (is_empty()) throw out_of_range("pop_front() call from empty static-ring-buffer-deque"s);
+        // В случае пустого дека сообщаем об ошибке политике ErrorPolicy
+        // (по умолчанию выбрасывается исключение, а AbortErrorPolicy подходит для сборок без исключений)
+        if (is_empty()) ErrorPolicy::out_of_range("pop_front() call from empty static-ring-buffer-deque");
 
         Type value = buff_[head_index_];            // Сначала забираем значение из начала диапазона
         head_index_ = increment_cycle(head_index_); // Затем смещаем индекс начала диапазона и "вращаем барабан" (инкремент + взятие по модулю)
@@ -146,26 +190,24 @@ public:
     }
 
     // Функция получения ссылки на элемент с определённым индексом
-    Type& operator [] (size_t index) {
+    constexpr Type& operator [] (size_t index) {
         using namespace std;
 
-        // В случае попытки получения ссылки на элемент с индексом за границей диапазона значений дека, выбразываем исключение
-        // (также можно было бы поставить assert(0u <= index && index < size_) для DEBUG-конфигурации,
-        // возможно использование механизма исключений на таком уровне нецелесообразно)
-        if (index < 0u || index >= size_) throw out_of_range("operator [] call for out of range index"s);
+        // В случае попытки получения ссылки на элемент с индексом за границей диапазона значений дека, сообщаем об ошибке политике ErrorPolicy
+        // (по умолчанию выбрасывается исключение, а AbortErrorPolicy подходит для сборок без исключений)
+        if (index >= size_) ErrorPolicy::out_of_range("operator [] call for out of range index");
 
         return buff_[(head_index_ + index) % capacity_]; // Возвращаем значение
     }
 
     // Функция получения константной ссылки на элемент с определённым индексом
     // (аналогична предыдущей, но для константных деков)
-    const Type& operator [] (size_t index) const {
+    constexpr const Type& operator [] (size_t index) const {
         using namespace std;
 
-        // В случае попытки получения ссылки на элемент с индексом за границей диапазона значений дека, выбразываем исключение
-        // (также можно было бы поставить assert(0u <= index && index < size_) для DEBUG-конфигурации,
-        // возможно использование механизма исключений на таком уровне нецелесообразно)
-        if (index < 0u || index >= size_) throw out_of_range("operator [] call for out of range index"s);
+        // В случае попытки получения ссылки на элемент с индексом за границей диапазона значений дека, сообщаем об ошибке политике ErrorPolicy
+        // (по умолчанию выбрасывается исключение, а AbortErrorPolicy подходит для сборок без исключений)
+        if (index >= size_) ErrorPolicy::out_of_range("operator [] call for out of range index");
 
         return buff_[(head_index_ + index) % capacity_]; // Возвращаем значение
     }
@@ -173,8 +215,8 @@ public:
 };
 
 // Перегрузка оператора "<<" для вывода элементов дека в поток
-template <typename Type, size_t capacity_>
-std::ostream& operator << (std::ostream& os, const StaticRingBufferDeque<Type, capacity_>& static_deque) {
+template <typename Type, size_t capacity_, typename ErrorPolicy>
+std::ostream& operator << (std::ostream& os, const StaticRingBufferDeque<Type, capacity_, ErrorPolicy>& static_deque) {
     using namespace std;
 
     os << "["s;
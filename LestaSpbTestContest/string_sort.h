@@ -0,0 +1,135 @@
+#pragma once
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <future>
+#include <cstdint>
+#include <cmath>
+
+namespace string_sort {
+
+// Размер диапазона, начиная с которого выгоднее сортировка вставками
+constexpr std::ptrdiff_t INSERTION_SORT_SIZE = 16;
+
+// Функция получения символа строки value на позиции depth как числа в [0; 255] (в том же порядке, в котором
+// сравнивает строки std::string, т.е. как unsigned char), или -1, если строка короче (конец строки меньше любого символа)
+template <typename StringLike>
+int16_t CharAt(const StringLike& value, size_t depth) {
+    const std::string_view view(value);
+    return depth < view.size() ? static_cast<int16_t>(static_cast<unsigned char>(view[depth])) : int16_t{ -1 };
+}
+
+// Функция сортировки вставками для небольших диапазонов, у строк которых первые depth символов заведомо
+// совпадают (общий префикс не сравнивается повторно)
+template <typename RandomIt>
+void InsertionSortFromDepth(RandomIt begin, RandomIt end, size_t depth) {
+    using namespace std;
+
+    // Функция получения суффикса строки после общего префикса
+    auto suffix = [depth](const auto& value) {
+        const string_view view(value);
+        return depth < view.size() ? view.substr(depth) : string_view();
+    };
+
+    for (RandomIt current = begin; current != end; ++current) {
+        for (RandomIt it = current; it != begin && suffix(*it) < suffix(*prev(it)); --it) {
+            iter_swap(it, prev(it)); // Обмен строк не копирует их содержимое
+        }
+    }
+}
+
+// Параллельная функция многоключевой быстрой сортировки (multikey quicksort) строк в диапазоне [begin; end), у
+// которых первые depth символов заведомо совпадают. Диапазон делится на три части по символу на позиции depth:
+// меньше опорного, равные ему и больше его. Крайние части сортируются рекурсивно с той же позицией, а в средней
+// сравнение продолжается со следующего символа, так что общие префиксы не сравниваются повторно
+//
+// Символы на текущей позиции кэшируются в непрерывном массиве keys (keys[i] соответствует begin[i]), поэтому
+// разбиение идёт по плотному массиву коротких чисел, а строки только обмениваются (без копирования содержимого)
+template <typename RandomIt>
+void StringSort(RandomIt begin, RandomIt end, int16_t* keys, size_t depth, int max_async_depth, int async_depth) {
+    using namespace std;
+
+    // Задачи, запущенные параллельно (дожидаемся их перед выходом)
+    vector<future<void>> futures;
+
+    // Средняя часть обрабатывается циклом, а не рекурсией (иначе глубина рекурсии росла бы с длиной общего префикса)
+    while (distance(begin, end) > INSERTION_SORT_SIZE) {
+        const ptrdiff_t range_length = distance(begin, end);
+
+        // Кэшируем символы текущей позиции
+        for (ptrdiff_t i = 0; i < range_length; ++i) keys[i] = CharAt(begin[i], depth);
+
+        // Опорный символ - медиана из трёх
+        const int16_t a = keys[0], b = keys[range_length / 2], c = keys[range_length - 1];
+        const int16_t pivot = max(min(a, b), min(max(a, b), c));
+
+        // Трёхчастное разбиение (Дейкстры) синхронно по keys и строкам:
+        // [0; lt) - меньше опорного, [lt; gt) - равные, [gt; range_length) - больше опорного
+        ptrdiff_t lt = 0, i = 0, gt = range_length;
+        while (i < gt) {
+            if (keys[i] < pivot) {
+                swap(keys[lt], keys[i]); iter_swap(begin + lt, begin + i); ++lt; ++i;
+            }
+            else if (keys[i] > pivot) {
+                --gt; swap(keys[gt], keys[i]); iter_swap(begin + gt, begin + i);
+            }
+            else ++i;
+        }
+
+        // Задачи (лямбды) для сортировки частей меньше и больше опорного
+        auto less_task    = [begin, lt, keys, depth, max_async_depth, async_depth] {
+            StringSort(begin, begin + lt, keys, depth, max_async_depth, async_depth + 1);
+        };
+        auto greater_task = [begin, gt, range_length, keys, depth, max_async_depth, async_depth] {
+            StringSort(begin + gt, begin + range_length, keys + gt, depth, max_async_depth, async_depth + 1);
+        };
+
+        // Если текущий уровень меньше, чем максимальный - запускаем непустые задачи параллельно
+        // с помощью std::async, а иначе выполним их последовательно
+        if (async_depth <= max_async_depth) {
+            if (lt > 1)                futures.push_back(async(less_task));
+            if (range_length - gt > 1) futures.push_back(async(greater_task));
+        }
+        else {
+            less_task();
+            greater_task();
+        }
+
+        // Если опорный символ - конец строки, то все строки средней части равны и уже отсортированы
+        if (pivot < 0) { begin = end; break; }
+
+        // А иначе продолжаем сортировку средней части со следующего символа
+        begin = begin + lt;
+        end   = begin + (gt - lt);
+        keys += lt;
+        ++depth;
+        ++async_depth;
+    }
+
+    // Небольшой остаток сортируем вставками
+    InsertionSortFromDepth(begin, end, depth);
+
+    for (auto& f : futures) f.get();
+}
+
+// Параллельная функция сортировки строк (std::string, std::string_view или других типов, приводимых
+// к std::string_view) в диапазоне [begin; end). Массив std::string_view сортируется без копирования строк
+template <typename RandomIt>
+void StringSort(RandomIt begin, RandomIt end) {
+    using namespace std;
+
+    const ptrdiff_t range_length = distance(begin, end);
+    if (range_length < 2) return;
+
+    // Установим максимальную глубину рекурсии с параллельным запуском как O(log N)
+    const int max_async_depth = static_cast<int>(log(static_cast<double>(range_length)));
+
+    // Массив для кэширования символов
+    vector<int16_t> keys(static_cast<size_t>(range_length));
+
+    StringSort(begin, end, keys.data(), 0u, max_async_depth, 0);
+}
+
+}
\ No newline at end of file